@@ -0,0 +1,80 @@
+#include "arena.h"
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+
+namespace {
+
+// Leaves room for a few more scratch buffers before the first reset can grow the arena.
+constexpr size_t MIN_BLOCK_SIZE = 64 * 1024;
+
+auto alignUp(size_t offset, size_t alignment) -> size_t { return (offset + alignment - 1) & ~(alignment - 1); }
+
+} // namespace
+
+LinearArena::LinearArena(size_t initial_capacity) {
+    if (initial_capacity > 0) {
+        addBlock(initial_capacity);
+    }
+}
+
+auto LinearArena::addBlock(size_t min_size) -> void {
+    auto size = std::max({min_size, MIN_BLOCK_SIZE, blocks_.empty() ? 0 : 2 * blocks_.back().size});
+    blocks_.push_back(Block{.data = std::make_unique_for_overwrite<std::byte[]>(size), .size = size});
+    offset_ = 0;
+}
+
+auto LinearArena::allocateBytes(size_t size, size_t alignment) -> void * {
+    assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+    assert(alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+
+    auto aligned_offset = alignUp(offset_, alignment);
+    if (blocks_.empty() || aligned_offset + size > blocks_.back().size) {
+        addBlock(size);
+        aligned_offset = 0;
+    }
+
+    auto *memory = blocks_.back().data.get() + aligned_offset;
+    bytes_used_ += (aligned_offset - offset_) + size;
+    high_water_mark_ = std::max(high_water_mark_, bytes_used_);
+    offset_ = aligned_offset + size;
+
+    return memory;
+}
+
+auto LinearArena::reset() -> void {
+    // If the frame didn't fit, replace all blocks with a single one that would have been big enough. Allocations
+    // that started a new block skipped their alignment padding, so leave room for that too.
+    if (blocks_.size() > 1) {
+        auto size = high_water_mark_ + blocks_.size() * __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+        blocks_.clear();
+        addBlock(size);
+    }
+
+    offset_ = 0;
+    bytes_used_ = 0;
+}
+
+auto LinearArena::capacity() const -> size_t {
+    return std::accumulate(blocks_.begin(), blocks_.end(), size_t{0},
+                           [](size_t total, Block const &block) { return total + block.size; });
+}
+
+FrameArena::FrameArena(int num_threads) : arenas_(num_threads) {}
+
+auto FrameArena::reset() -> void {
+    for (auto &arena : arenas_) {
+        arena.reset();
+    }
+}
+
+auto FrameArena::bytesUsed() const -> size_t {
+    return std::accumulate(arenas_.begin(), arenas_.end(), size_t{0},
+                           [](size_t total, LinearArena const &arena) { return total + arena.bytesUsed(); });
+}
+
+auto FrameArena::highWaterMark() const -> size_t {
+    return std::accumulate(arenas_.begin(), arenas_.end(), size_t{0},
+                           [](size_t total, LinearArena const &arena) { return total + arena.highWaterMark(); });
+}
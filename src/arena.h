@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+// Bump allocator for data that only lives until the end of the frame. Nothing is freed individually, reset() hands
+// everything back at once and keeps the memory around, so once the arena has grown to fit a frame, later frames of
+// the same size don't touch the heap at all.
+class LinearArena {
+    struct Block {
+        std::unique_ptr<std::byte[]> data;
+        size_t size;
+    };
+
+    // The first block is the one that gets reused; the others only exist until the next reset.
+    std::vector<Block> blocks_;
+    size_t offset_ = 0;
+    size_t bytes_used_ = 0;
+    size_t high_water_mark_ = 0;
+
+    auto addBlock(size_t min_size) -> void;
+
+  public:
+    explicit LinearArena(size_t initial_capacity = 0);
+
+    auto allocateBytes(size_t size, size_t alignment) -> void *;
+
+    // Memory is default-initialized, so trivial types come back with indeterminate values.
+    template <typename T> auto allocate(size_t count) -> std::span<T> {
+        static_assert(std::is_trivially_destructible_v<T>, "Arena memory is never destroyed");
+        auto *memory = static_cast<T *>(allocateBytes(count * sizeof(T), alignof(T)));
+        std::uninitialized_default_construct_n(memory, count);
+        return std::span<T>{memory, count};
+    }
+
+    auto reset() -> void;
+
+    auto bytesUsed() const -> size_t { return bytes_used_; }
+    auto highWaterMark() const -> size_t { return high_water_mark_; }
+    auto capacity() const -> size_t;
+};
+
+// One LinearArena per thread, so workers never contend on allocations.
+class FrameArena {
+    std::vector<LinearArena> arenas_;
+
+  public:
+    explicit FrameArena(int num_threads);
+
+    auto forThread(int thread_index) -> LinearArena & { return arenas_[thread_index]; }
+
+    auto reset() -> void;
+
+    auto bytesUsed() const -> size_t;
+    auto highWaterMark() const -> size_t;
+};
@@ -0,0 +1,148 @@
+#include "batch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+#include "arena.h"
+#include "benchmark.h"
+#include "drawing.h"
+#include "framebuffer.h"
+#include "image_writer.h"
+#include "transform.h"
+
+namespace {
+
+auto const BACKGROUND_COLOR = cv::Vec3b(255, 200, 200);
+
+// Enough to absorb a burst of slow writes without holding too many full-size frames in memory.
+constexpr size_t MAX_QUEUED_IMAGES_PER_WORKER = 4;
+
+bool tryParseJob(std::string const &line, std::vector<CameraJob> &jobs) {
+    auto job = CameraJob{};
+    auto stream = std::stringstream{line};
+    stream >> job.eye.x >> job.eye.y >> job.eye.z;
+    stream >> job.at.x >> job.at.y >> job.at.z;
+    stream >> job.up.x >> job.up.y >> job.up.z;
+    stream >> job.fov_y_degrees >> job.width >> job.height >> job.output_path;
+
+    if (stream.fail())
+        return false;
+
+    if (auto format_name = std::string{}; stream >> format_name) {
+        auto format = parseDepthFormat(format_name);
+        if (!format)
+            return false;
+        job.depth_format = *format;
+
+        if (auto near_plane = 0.f; stream >> near_plane) {
+            if (!(near_plane > 0))
+                return false;
+            job.near_plane = near_plane;
+        }
+    }
+
+    if (!(stream >> std::ws).eof())
+        return false;
+
+    if (job.width <= 0 || job.height <= 0 || job.fov_y_degrees <= 0 || job.fov_y_degrees >= 180)
+        return false;
+
+    jobs.push_back(std::move(job));
+    return true;
+}
+
+auto renderJob(FrameBuffer &fb, Mesh const &mesh, BoundingSphere const &bounds, CameraJob const &job,
+               LinearArena &scratch) -> void {
+    if (fb.render_target.cols != job.width || fb.render_target.rows != job.height ||
+        fb.depth_format != job.depth_format) {
+        fb = createFrameBuffer(job.width, job.height, job.depth_format);
+    }
+
+    auto aspect_ratio = job.width / static_cast<float>(job.height);
+    auto view = lookAt(job.eye, job.at, job.up);
+    auto near_plane = job.near_plane.value_or(fitNearPlane(view, bounds.center, bounds.radius));
+    auto transform = view * projectionTransform(job.fov_y_degrees, aspect_ratio, near_plane);
+
+    clear(fb, BACKGROUND_COLOR);
+    drawMesh(fb, mesh, transform, scratch);
+}
+
+} // namespace
+
+auto readCameraJobs(std::string const &path) -> std::optional<std::vector<CameraJob>> {
+    auto input_file = std::ifstream(path);
+    if (!input_file.good()) {
+        std::cerr << "Failed to open file '" << path << "'" << std::endl;
+        return {};
+    }
+
+    auto jobs = std::vector<CameraJob>{};
+    auto line_number = 0;
+    for (std::string line; std::getline(input_file, line);) {
+        line_number += 1;
+
+        auto first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#')
+            continue;
+
+        if (!tryParseJob(line, jobs)) {
+            std::cerr << "Invalid job on line " << line_number << ": '" << line << "'" << std::endl;
+            return {};
+        }
+    }
+
+    return jobs;
+}
+
+auto renderBatch(Mesh const &mesh, std::vector<CameraJob> const &jobs, int num_workers) -> BatchStats {
+    num_workers = std::clamp(num_workers, 1, std::max(1, static_cast<int>(std::ssize(jobs))));
+
+    auto timer = BenchmarkTimer();
+    auto writer = ImageWriter(MAX_QUEUED_IMAGES_PER_WORKER * num_workers);
+
+    auto bounds = boundingSphere(mesh);
+    auto next_job = std::atomic<size_t>{0};
+    auto encode_failures = std::atomic<int>{0};
+
+    // Workers finish their frames at different times, so each one resets its own part of the arena.
+    auto frame_arena = FrameArena(num_workers);
+
+    auto work = [&](int worker_index) {
+        auto &scratch = frame_arena.forThread(worker_index);
+        auto fb = FrameBuffer{};
+        auto encoded = std::vector<uint8_t>{};
+
+        for (auto i = next_job++; i < jobs.size(); i = next_job++) {
+            auto const &job = jobs[i];
+            renderJob(fb, mesh, bounds, job, scratch);
+            scratch.reset();
+
+            if (!cv::imencode(".png", fb.render_target, encoded)) {
+                std::cerr << "Failed to encode image '" << job.output_path << "'" << std::endl;
+                encode_failures += 1;
+                continue;
+            }
+            writer.enqueue(job.output_path, std::move(encoded));
+            encoded = std::vector<uint8_t>{};
+        }
+    };
+
+    auto workers = std::vector<std::jthread>{};
+    workers.reserve(num_workers);
+    for (int i = 0; i < num_workers; ++i) {
+        workers.emplace_back(work, i);
+    }
+    workers.clear();
+
+    auto frames_failed = encode_failures + writer.finish();
+    auto seconds = timer.GetNanosAndReset() * 1.e-9;
+
+    return BatchStats{.frames_rendered = static_cast<int>(std::ssize(jobs)) - frames_failed,
+                      .frames_failed = frames_failed,
+                      .seconds = seconds,
+                      .arena_high_water_mark = frame_arena.highWaterMark()};
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "framebuffer.h"
+#include "math.h"
+#include "mesh.h"
+
+struct CameraJob {
+    Vec3 eye;
+    Vec3 at;
+    Vec3 up;
+    float fov_y_degrees;
+    int width;
+    int height;
+    std::string output_path;
+    DepthFormat depth_format = DepthFormat::Float32;
+    // Fitted to the mesh bounds when unset.
+    std::optional<float> near_plane;
+};
+
+// Each non-empty line that isn't a comment describes one frame:
+//   eye_x eye_y eye_z  at_x at_y at_z  up_x up_y up_z  fov_y_degrees  width height  output_path
+// optionally followed by a depth format name as accepted by parseDepthFormat and then a near plane distance.
+auto readCameraJobs(std::string const &path) -> std::optional<std::vector<CameraJob>>;
+
+struct BatchStats {
+    int frames_rendered;
+    int frames_failed;
+    double seconds;
+    size_t arena_high_water_mark;
+};
+
+// Renders all jobs on `num_workers` threads, each with its own frame buffer. The mesh is only ever read.
+auto renderBatch(Mesh const &mesh, std::vector<CameraJob> const &jobs, int num_workers) -> BatchStats;
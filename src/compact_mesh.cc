@@ -0,0 +1,170 @@
+#include "compact_mesh.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <span>
+
+namespace {
+
+constexpr float QUANTIZATION_STEPS = std::numeric_limits<uint16_t>::max();
+
+struct Bounds {
+    float min = std::numeric_limits<float>::max();
+    float max = std::numeric_limits<float>::lowest();
+
+    auto add(float value) -> void {
+        min = std::min(min, value);
+        max = std::max(max, value);
+    }
+
+    auto scale() const -> float { return (max - min) / QUANTIZATION_STEPS; }
+};
+
+auto quantize(float value, float offset, float scale) -> uint16_t {
+    if (scale == 0)
+        return 0;
+
+    auto steps = std::round((value - offset) / scale);
+    return static_cast<uint16_t>(std::clamp(steps, 0.f, QUANTIZATION_STEPS));
+}
+
+// Offsets and scales shared by every cluster of a mesh. With the same grid everywhere, a vertex that ends up in several
+// clusters gets the same codes and the same decode transform in each, so cluster seams stay watertight.
+struct QuantizationGrid {
+    Vec3 position_offset;
+    Vec3 position_scale;
+    Vec2 coords_offset;
+    Vec2 coords_scale;
+};
+
+auto makeQuantizationGrid(std::span<Vertex const> vertices) -> QuantizationGrid {
+    auto bounds = std::array<Bounds, 5>{};
+    for (auto const &[position, texture_coords] : vertices) {
+        bounds[0].add(position.x);
+        bounds[1].add(position.y);
+        bounds[2].add(position.z);
+        bounds[3].add(texture_coords.x);
+        bounds[4].add(texture_coords.y);
+    }
+
+    return QuantizationGrid{
+        .position_offset = Vec3{bounds[0].min, bounds[1].min, bounds[2].min},
+        .position_scale = Vec3{bounds[0].scale(), bounds[1].scale(), bounds[2].scale()},
+        .coords_offset = Vec2{bounds[3].min, bounds[4].min},
+        .coords_scale = Vec2{bounds[3].scale(), bounds[4].scale()},
+    };
+}
+
+auto quantizeCluster(std::span<Vertex const> vertices, QuantizationGrid const &grid, int first_index, int index_count,
+                     int first_vertex, std::vector<CompactVertex> &compact_vertices) -> MeshCluster {
+    auto const &offset = grid.position_offset;
+    auto const &scale = grid.position_scale;
+    for (auto const &[position, texture_coords] : vertices) {
+        compact_vertices.push_back(CompactVertex{
+            .position = {quantize(position.x, offset.x, scale.x), quantize(position.y, offset.y, scale.y),
+                         quantize(position.z, offset.z, scale.z)},
+            .texture_coords = {quantize(texture_coords.x, grid.coords_offset.x, grid.coords_scale.x),
+                               quantize(texture_coords.y, grid.coords_offset.y, grid.coords_scale.y)},
+        });
+    }
+
+    return MeshCluster{
+        .position_offset = grid.position_offset,
+        .position_scale = grid.position_scale,
+        .coords_offset = grid.coords_offset,
+        .coords_scale = grid.coords_scale,
+        .first_vertex = first_vertex,
+        .vertex_count = static_cast<int>(std::ssize(vertices)),
+        .first_index = first_index,
+        .index_count = index_count,
+    };
+}
+
+} // namespace
+
+auto compressMesh(Mesh const &mesh, int max_cluster_vertices) -> CompactMesh {
+    assert(isMeshValid(mesh));
+    assert(max_cluster_vertices >= 3 && max_cluster_vertices <= MAX_CLUSTER_VERTICES);
+
+    auto compact = CompactMesh{};
+    compact.indices.reserve(mesh.indices.size());
+
+    auto grid = makeQuantizationGrid(mesh.vertices);
+
+    // Position of each mesh vertex in the current cluster, or -1.
+    auto local_index = std::vector<int>(mesh.vertices.size(), -1);
+    auto cluster_vertices = std::vector<Vertex>{};
+    auto cluster_globals = std::vector<int>{};
+    auto cluster_first_index = 0;
+
+    auto finish_cluster = [&] {
+        if (cluster_vertices.empty())
+            return;
+
+        auto index_count = static_cast<int>(std::ssize(compact.indices)) - cluster_first_index;
+        auto first_vertex = static_cast<int>(std::ssize(compact.vertices));
+        compact.clusters.push_back(
+            quantizeCluster(cluster_vertices, grid, cluster_first_index, index_count, first_vertex, compact.vertices));
+
+        for (auto global : cluster_globals) {
+            local_index[global] = -1;
+        }
+        cluster_vertices.clear();
+        cluster_globals.clear();
+        cluster_first_index = static_cast<int>(std::ssize(compact.indices));
+    };
+
+    auto const n = std::ssize(mesh.indices);
+    for (auto i = 0; i < n; i += 3) {
+        auto new_vertices = 0;
+        for (auto j = i; j < i + 3; ++j) {
+            new_vertices += local_index[mesh.indices[j]] < 0;
+        }
+
+        if (std::ssize(cluster_vertices) + new_vertices > max_cluster_vertices) {
+            finish_cluster();
+        }
+
+        for (auto j = i; j < i + 3; ++j) {
+            auto global = mesh.indices[j];
+            if (local_index[global] < 0) {
+                local_index[global] = static_cast<int>(std::ssize(cluster_vertices));
+                cluster_vertices.push_back(mesh.vertices[global]);
+                cluster_globals.push_back(global);
+            }
+            compact.indices.push_back(static_cast<uint16_t>(local_index[global]));
+        }
+    }
+    finish_cluster();
+
+    return compact;
+}
+
+auto isMeshValid(CompactMesh const &mesh) -> bool {
+    if (mesh.indices.size() % 3 != 0)
+        return false;
+
+    auto is_cluster_ok = [&](MeshCluster const &cluster) {
+        if (cluster.first_vertex < 0 || cluster.first_vertex + cluster.vertex_count > std::ssize(mesh.vertices))
+            return false;
+
+        if (cluster.index_count % 3 != 0 || cluster.first_index < 0 ||
+            cluster.first_index + cluster.index_count > std::ssize(mesh.indices))
+            return false;
+
+        auto indices = std::span{mesh.indices}.subspan(cluster.first_index, cluster.index_count);
+        return std::ranges::all_of(indices, [&](uint16_t index) { return index < cluster.vertex_count; });
+    };
+    return std::ranges::all_of(mesh.clusters, is_cluster_ok);
+}
+
+auto memoryFootprint(Mesh const &mesh) -> size_t {
+    return mesh.vertices.size() * sizeof(Vertex) + mesh.indices.size() * sizeof(int);
+}
+
+auto memoryFootprint(CompactMesh const &mesh) -> size_t {
+    return mesh.vertices.size() * sizeof(CompactVertex) + mesh.indices.size() * sizeof(uint16_t) +
+           mesh.clusters.size() * sizeof(MeshCluster);
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "math.h"
+#include "mesh.h"
+
+// Half the size of Vertex. Both attributes are 16-bit unorm values relative to the bounds of the whole mesh.
+struct CompactVertex {
+    std::array<uint16_t, 3> position;
+    std::array<uint16_t, 2> texture_coords;
+};
+
+static_assert(sizeof(CompactVertex) == 10);
+
+// A run of triangles that references few enough vertices for 16-bit indices. Decoded attributes are
+// `offset + scale * quantized`. compressMesh gives every cluster the same offsets and scales, so vertices shared across
+// clusters decode to exactly the same position.
+struct MeshCluster {
+    Vec3 position_offset;
+    Vec3 position_scale;
+    Vec2 coords_offset;
+    Vec2 coords_scale;
+
+    int first_vertex;
+    int vertex_count;
+    int first_index;
+    int index_count;
+};
+
+struct CompactMesh {
+    std::vector<CompactVertex> vertices;
+    // Relative to the first vertex of the cluster they belong to.
+    std::vector<uint16_t> indices;
+    std::vector<MeshCluster> clusters;
+};
+
+constexpr int MAX_CLUSTER_VERTICES = 1 << 16;
+
+// Splits the mesh into clusters in index order and quantizes all of them on one grid spanning the mesh bounds.
+auto compressMesh(Mesh const &mesh, int max_cluster_vertices = MAX_CLUSTER_VERTICES) -> CompactMesh;
+
+auto isMeshValid(CompactMesh const &mesh) -> bool;
+
+auto memoryFootprint(Mesh const &mesh) -> size_t;
+auto memoryFootprint(CompactMesh const &mesh) -> size_t;
@@ -4,28 +4,15 @@
 #include <cmath>
 
 #include "math.h"
+#include "transform.h"
 
 namespace {
 
-auto operator*(Vertex const &vertex, Mat4 const &transform) -> Vec3 {
-    auto const &[x, y, z] = vertex.position;
-    auto v2 = Vec4{x, y, z, 1} * transform;
-
-    auto const &x2 = v2[0];
-    auto const &y2 = v2[1];
-    auto const &z2 = v2[2];
-    auto const &w2 = v2[3];
-
-    return w2 == 0 ? Vec3{0, 0, 0} : Vec3{x2 / w2, y2 / w2, z2 / w2};
-}
-
 struct Vec2i {
     int64_t x;
     int64_t y;
 };
 
-using Triangle = std::array<Vertex, 3>;
-
 auto remapToScreen(cv::Mat const &img, Triangle const &triangle) {
     auto half = Vec2((img.cols - 1) / 2.f, (img.rows - 1) / 2.f);
 
@@ -54,13 +41,13 @@ struct Rect {
     int64_t x1, y1, x2, y2;
 };
 
-auto getTriangleBounds(cv::Mat const &img, std::array<Vec2i, 3> const &triangle) -> Rect {
+auto getTriangleBounds(cv::Rect const &clip, std::array<Vec2i, 3> const &triangle) -> Rect {
     auto const &[a, b, c] = triangle;
 
-    auto x1 = std::max(min(a.x, b.x, c.x), 0L);
-    auto x2 = std::min(max(a.x, b.x, c.x), int64_t{img.cols - 1});
-    auto y1 = std::max(min(a.y, b.y, c.y), 0L);
-    auto y2 = std::min(max(a.y, b.y, c.y), int64_t{img.rows - 1});
+    auto x1 = std::max(min(a.x, b.x, c.x), int64_t{clip.x});
+    auto x2 = std::min(max(a.x, b.x, c.x), int64_t{clip.x + clip.width - 1});
+    auto y1 = std::max(min(a.y, b.y, c.y), int64_t{clip.y});
+    auto y2 = std::min(max(a.y, b.y, c.y), int64_t{clip.y + clip.height - 1});
 
     return Rect{.x1 = x1, .y1 = y1, .x2 = x2, .y2 = y2};
 }
@@ -82,7 +69,14 @@ auto makeEdgeFunction(Vec2i const &v1, Vec2i const &v2) {
     return EdgeFunction(base, dx, dy);
 }
 
+} // namespace
+
 auto drawTriangle(FrameBuffer &fb, Triangle const &vertices) -> void {
+    auto whole_screen = cv::Rect{0, 0, fb.render_target.cols, fb.render_target.rows};
+    drawTriangle(fb, vertices, std::span{&whole_screen, 1});
+}
+
+auto drawTriangle(FrameBuffer &fb, Triangle const &vertices, std::span<cv::Rect const> clip_regions) -> void {
     auto screen_space = remapToScreen(fb.render_target, vertices);
     auto const &[ss_a, ss_b, ss_c] = screen_space;
 
@@ -113,74 +107,134 @@ auto drawTriangle(FrameBuffer &fb, Triangle const &vertices) -> void {
         return;
     }
 
-    auto bounds = getTriangleBounds(fb.render_target, screen_space);
+    for (auto const &clip : clip_regions) {
+        auto bounds = getTriangleBounds(clip, screen_space);
 
-    for (int y = bounds.y1; y <= bounds.y2; ++y) {
-        assert(y >= 0 && y < fb.render_target.rows);
+        for (int y = bounds.y1; y <= bounds.y2; ++y) {
+            assert(y >= 0 && y < fb.render_target.rows);
 
-        for (int x = bounds.x1; x <= bounds.x2; ++x) {
-            assert(x >= 0 && x < fb.render_target.cols);
+            for (int x = bounds.x1; x <= bounds.x2; ++x) {
+                assert(x >= 0 && x < fb.render_target.cols);
 
-            auto u = get_u(Vec2i{x, y});
-            auto v = get_v(Vec2i{x, y});
-            auto w = get_w(Vec2i{x, y});
+                auto u = get_u(Vec2i{x, y});
+                auto v = get_v(Vec2i{x, y});
+                auto w = get_w(Vec2i{x, y});
 
-            // TODO: This also does back-face culling. Might want to change that.
-            if (u < 0 || v < 0 || w < 0)
-                continue;
+                // TODO: This also does back-face culling. Might want to change that.
+                if (u < 0 || v < 0 || w < 0)
+                    continue;
 
-            auto inverse_depth = (u * inv_depth[0] + v * inv_depth[1] + w * inv_depth[2]) / (u + v + w);
-            auto depth = 1.f / inverse_depth;
+                auto inverse_depth = (u * inv_depth[0] + v * inv_depth[1] + w * inv_depth[2]) / (u + v + w);
+                auto depth = 1.f / inverse_depth;
 
-            auto nu = u / float(u + v + w);
-            auto nv = v / float(u + v + w);
-            auto nw = w / float(u + v + w);
+                auto nu = u / float(u + v + w);
+                auto nv = v / float(u + v + w);
+                auto nw = w / float(u + v + w);
 
-            auto interpolate = [&](float a, float b, float c) -> float { return (a * nu) + (b * nv) + (c * nw); };
-            auto interpolate_perspective = [&](float a, float b, float c) -> float {
-                auto az = a * inv_depth[0];
-                auto bz = b * inv_depth[1];
-                auto cz = c * inv_depth[2];
-                return (interpolate(az, bz, cz) * depth);
-            };
+                auto interpolate = [&](float a, float b, float c) -> float { return (a * nu) + (b * nv) + (c * nw); };
+                auto interpolate_perspective = [&](float a, float b, float c) -> float {
+                    auto az = a * inv_depth[0];
+                    auto bz = b * inv_depth[1];
+                    auto cz = c * inv_depth[2];
+                    return (interpolate(az, bz, cz) * depth);
+                };
 
-            auto tx_u = interpolate_perspective(vertices[0].texture_coords.x, vertices[1].texture_coords.x,
-                                                vertices[2].texture_coords.x);
-            auto tx_v = interpolate_perspective(vertices[0].texture_coords.y, vertices[1].texture_coords.y,
-                                                vertices[2].texture_coords.y);
+                auto tx_u = interpolate_perspective(vertices[0].texture_coords.x, vertices[1].texture_coords.x,
+                                                    vertices[2].texture_coords.x);
+                auto tx_v = interpolate_perspective(vertices[0].texture_coords.y, vertices[1].texture_coords.y,
+                                                    vertices[2].texture_coords.y);
 
-            auto checkerboard = [](float a, float b) -> uint8_t {
-                auto a2 = static_cast<int>(std::round(256 * a));
-                auto a3 = a2 / 8;
-                auto b2 = static_cast<int>(std::round(256 * b));
-                auto b3 = b2 / 8;
-                return ((a3 ^ b3) & 1) ? 255 : 0;
-            };
+                auto checkerboard = [](float a, float b) -> uint8_t {
+                    auto a2 = static_cast<int>(std::round(256 * a));
+                    auto a3 = a2 / 8;
+                    auto b2 = static_cast<int>(std::round(256 * b));
+                    auto b3 = b2 / 8;
+                    return ((a3 ^ b3) & 1) ? 255 : 0;
+                };
 
-            auto color = cv::Vec3b{static_cast<uint8_t>(std::round(255 * tx_u)),
-                                   static_cast<uint8_t>(std::round(255 * tx_v)), checkerboard(tx_u, tx_v)};
+                auto color = cv::Vec3b{static_cast<uint8_t>(std::round(255 * tx_u)),
+                                       static_cast<uint8_t>(std::round(255 * tx_v)), checkerboard(tx_u, tx_v)};
 
-            setPixel(fb, x, y, inverse_depth, color);
+                setPixel(fb, x, y, inverse_depth, color);
+            }
         }
     }
 }
 
-} // namespace
+auto transformVertices(std::span<Vertex const> vertices, Mat4 const &transform, std::span<Vertex> out) -> void {
+    assert(out.size() >= vertices.size());
+
+    auto get_position = [&](int64_t i) { return vertices[i].position; };
+    auto store = [&](int64_t i, Vec3 const &position) {
+        out[i] = Vertex{.position = position, .texture_coords = vertices[i].texture_coords};
+    };
+    transformPoints(std::ssize(vertices), transform, get_position, store);
+}
+
+auto transformVertices(std::span<CompactVertex const> vertices, MeshCluster const &cluster, Mat4 const &transform,
+                       std::span<Vertex> out) -> void {
+    assert(out.size() >= vertices.size());
+
+    // Dequantizing positions is affine, so it folds into the transform for free.
+    auto decode_and_transform =
+        scaleTransform(cluster.position_scale) * translationTransform(cluster.position_offset) * transform;
+    auto const &coords_offset = cluster.coords_offset;
+    auto const &coords_scale = cluster.coords_scale;
+
+    auto decode_position = [&](int64_t i) {
+        auto const &position = vertices[i].position;
+        return Vec3{static_cast<float>(position[0]), static_cast<float>(position[1]), static_cast<float>(position[2])};
+    };
+    auto store = [&](int64_t i, Vec3 const &position) {
+        auto const &texture_coords = vertices[i].texture_coords;
+        out[i] = Vertex{.position = position,
+                        .texture_coords = Vec2{coords_offset.x + coords_scale.x * texture_coords[0],
+                                               coords_offset.y + coords_scale.y * texture_coords[1]}};
+    };
+    transformPoints(std::ssize(vertices), decode_and_transform, decode_position, store);
+}
 
-auto drawMesh(FrameBuffer &fb, Mesh const &mesh, Mat4 const &transform) -> void {
+auto drawMesh(FrameBuffer &fb, Mesh const &mesh, Mat4 const &transform, LinearArena &scratch) -> void {
+    auto whole_screen = cv::Rect{0, 0, fb.render_target.cols, fb.render_target.rows};
+    drawMesh(fb, mesh, transform, scratch, std::span{&whole_screen, 1});
+}
+
+auto drawMesh(FrameBuffer &fb, Mesh const &mesh, Mat4 const &transform, LinearArena &scratch,
+              std::span<cv::Rect const> clip_regions) -> void {
     assert(isMeshValid(mesh));
 
-    auto vertices_transformed = std::vector<Vertex>{};
-    vertices_transformed.reserve(mesh.vertices.size());
-    for (auto const &v : mesh.vertices) {
-        vertices_transformed.push_back(Vertex{.position = v * transform, .texture_coords = v.texture_coords});
-    }
+    auto vertices_transformed = scratch.allocate<Vertex>(mesh.vertices.size());
+    transformVertices(mesh.vertices, transform, vertices_transformed);
 
     auto const n = std::ssize(mesh.indices);
     for (auto i = 0; i < n; i += 3) {
         auto triangle = Triangle{vertices_transformed[mesh.indices[i]], vertices_transformed[mesh.indices[i + 1]],
                                  vertices_transformed[mesh.indices[i + 2]]};
 
-        drawTriangle(fb, triangle);
+        drawTriangle(fb, triangle, clip_regions);
+    }
+}
+
+auto drawMesh(FrameBuffer &fb, CompactMesh const &mesh, Mat4 const &transform, LinearArena &scratch) -> void {
+    assert(isMeshValid(mesh));
+
+    if (mesh.clusters.empty())
+        return;
+
+    auto max_cluster_vertices = std::ranges::max(mesh.clusters, {}, &MeshCluster::vertex_count).vertex_count;
+    auto vertices_transformed = scratch.allocate<Vertex>(max_cluster_vertices);
+
+    for (auto const &cluster : mesh.clusters) {
+        auto vertices = std::span{mesh.vertices}.subspan(cluster.first_vertex, cluster.vertex_count);
+        transformVertices(vertices, cluster, transform, vertices_transformed);
+
+        auto indices = std::span{mesh.indices}.subspan(cluster.first_index, cluster.index_count);
+        auto const n = std::ssize(indices);
+        for (auto i = 0; i < n; i += 3) {
+            auto triangle = Triangle{vertices_transformed[indices[i]], vertices_transformed[indices[i + 1]],
+                                     vertices_transformed[indices[i + 2]]};
+
+            drawTriangle(fb, triangle);
+        }
     }
 }
@@ -1,7 +1,30 @@
 #pragma once
 
+#include <array>
+#include <span>
+
+#include "arena.h"
+#include "compact_mesh.h"
 #include "framebuffer.h"
 #include "math.h"
 #include "mesh.h"
 
-auto drawMesh(FrameBuffer &fb, Mesh const &mesh, Mat4 const &transform) -> void;
+using Triangle = std::array<Vertex, 3>;
+
+// Vertices are expected in clip space after the perspective divide, with inverse depth in z.
+auto drawTriangle(FrameBuffer &fb, Triangle const &vertices) -> void;
+// Same, but only pixels inside one of `clip_regions` get written. The regions have to lie within the framebuffer.
+auto drawTriangle(FrameBuffer &fb, Triangle const &vertices, std::span<cv::Rect const> clip_regions) -> void;
+
+// Vertex stage of drawMesh, `out` must be at least as long as `vertices`.
+auto transformVertices(std::span<Vertex const> vertices, Mat4 const &transform, std::span<Vertex> out) -> void;
+
+// Decodes the vertices of one cluster as part of the transform, `out` must hold at least `cluster.vertex_count`.
+auto transformVertices(std::span<CompactVertex const> vertices, MeshCluster const &cluster, Mat4 const &transform,
+                       std::span<Vertex> out) -> void;
+
+// Scratch buffers come from `scratch`, which has to outlive the call but can be reset right after it.
+auto drawMesh(FrameBuffer &fb, Mesh const &mesh, Mat4 const &transform, LinearArena &scratch) -> void;
+auto drawMesh(FrameBuffer &fb, Mesh const &mesh, Mat4 const &transform, LinearArena &scratch,
+              std::span<cv::Rect const> clip_regions) -> void;
+auto drawMesh(FrameBuffer &fb, CompactMesh const &mesh, Mat4 const &transform, LinearArena &scratch) -> void;
@@ -1,12 +1,97 @@
 #include "framebuffer.h"
 
+#include <cstdint>
+
 #include <opencv2/opencv.hpp>
 
-auto createFrameBuffer(int width, int height) -> FrameBuffer {
+namespace {
+
+constexpr uint32_t UNORM16_MAX = (1u << 16) - 1;
+constexpr uint32_t UNORM24_MAX = (1u << 24) - 1;
+
+auto toUnorm(float inv_depth, uint32_t max_value) -> uint32_t {
+    return static_cast<uint32_t>(inv_depth * max_value + 0.5f);
+}
+
+auto depthMatType(DepthFormat format) -> int {
+    switch (format) {
+    case DepthFormat::Float32:
+        return CV_32FC1;
+    case DepthFormat::Unorm16:
+        return CV_16UC1;
+    case DepthFormat::Unorm24:
+        return CV_8UC3;
+    }
+    return CV_32FC1;
+}
+
+// Returns false if the pixel is occluded, otherwise stores the new depth.
+auto testAndSetDepth(FrameBuffer &fb, int x, int y, float inv_depth) -> bool {
+    // Clamping these to the largest code would let whichever of them was drawn first win, regardless of depth.
+    if (fb.depth_format != DepthFormat::Float32 && inv_depth > 1)
+        return false;
+
+    switch (fb.depth_format) {
+    case DepthFormat::Float32: {
+        auto &stored = fb.depth_buffer.at<float>(y, x);
+        if (stored >= inv_depth)
+            return false;
+        stored = inv_depth;
+        return true;
+    }
+    case DepthFormat::Unorm16: {
+        auto &stored = fb.depth_buffer.at<uint16_t>(y, x);
+        auto encoded = toUnorm(inv_depth, UNORM16_MAX);
+        if (stored >= encoded)
+            return false;
+        stored = static_cast<uint16_t>(encoded);
+        return true;
+    }
+    case DepthFormat::Unorm24: {
+        auto *stored = fb.depth_buffer.ptr<uint8_t>(y) + 3 * x;
+        auto encoded = toUnorm(inv_depth, UNORM24_MAX);
+        if (stored[0] + (uint32_t{stored[1]} << 8) + (uint32_t{stored[2]} << 16) >= encoded)
+            return false;
+        stored[0] = static_cast<uint8_t>(encoded);
+        stored[1] = static_cast<uint8_t>(encoded >> 8);
+        stored[2] = static_cast<uint8_t>(encoded >> 16);
+        return true;
+    }
+    }
+    return false;
+}
+
+} // namespace
+
+auto depthBytesPerPixel(DepthFormat format) -> int {
+    switch (format) {
+    case DepthFormat::Float32:
+        return 4;
+    case DepthFormat::Unorm16:
+        return 2;
+    case DepthFormat::Unorm24:
+        return 3;
+    }
+    return 4;
+}
+
+auto parseDepthFormat(std::string_view name) -> std::optional<DepthFormat> {
+    if (name == "float32")
+        return DepthFormat::Float32;
+    if (name == "unorm16")
+        return DepthFormat::Unorm16;
+    if (name == "unorm24")
+        return DepthFormat::Unorm24;
+    return {};
+}
+
+auto createFrameBuffer(int width, int height, DepthFormat depth_format) -> FrameBuffer {
     auto render_target = cv::Mat::zeros(cv::Size{width, height}, CV_8UC3);
-    auto depth_buffer = cv::Mat::zeros(cv::Size{width, height}, CV_32FC1);
+    auto depth_buffer = cv::Mat::zeros(cv::Size{width, height}, depthMatType(depth_format));
 
-    return FrameBuffer{.render_target = std::move(render_target), .depth_buffer = std::move(depth_buffer)};
+    return FrameBuffer{.render_target = std::move(render_target),
+                       .depth_buffer = std::move(depth_buffer),
+                       .depth_format = depth_format};
 }
 
 auto clear(FrameBuffer &fb, cv::Vec3b color) -> void {
@@ -14,15 +99,19 @@ auto clear(FrameBuffer &fb, cv::Vec3b color) -> void {
     fb.depth_buffer.setTo(0.0);
 }
 
+auto clear(FrameBuffer &fb, cv::Vec3b color, cv::Rect const &region) -> void {
+    fb.render_target(region).setTo(color);
+    fb.depth_buffer(region).setTo(0.0);
+}
+
 auto setPixel(FrameBuffer &fb, int x, int y, float inv_depth, cv::Vec3b color) -> void {
     if (inv_depth < 0.0) {
         return;
     }
 
-    if (fb.depth_buffer.at<float>(y, x) >= inv_depth) {
+    if (!testAndSetDepth(fb, x, y, inv_depth)) {
         return;
     }
 
-    fb.depth_buffer.at<float>(y, x) = inv_depth;
     fb.render_target.at<cv::Vec3b>(y, x) = color;
 }
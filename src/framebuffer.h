@@ -1,13 +1,33 @@
 #pragma once
 
+#include <optional>
+#include <string_view>
+
 #include <opencv2/opencv.hpp>
 
+// All formats store inverse depth (reversed-Z): 0 is infinitely far away, larger values are closer. The unorm formats
+// cover [0, 1], which is what projectionTransform produces for everything beyond its near plane. They drop fragments in
+// front of the near plane, which float32 still depth-tests and draws.
+enum class DepthFormat {
+    Float32,
+    Unorm16,
+    // Packed into three bytes per pixel, least significant first.
+    Unorm24,
+};
+
+auto depthBytesPerPixel(DepthFormat format) -> int;
+// Accepts "float32", "unorm16" and "unorm24".
+auto parseDepthFormat(std::string_view name) -> std::optional<DepthFormat>;
+
 struct FrameBuffer {
     cv::Mat render_target;
     cv::Mat depth_buffer;
+    DepthFormat depth_format = DepthFormat::Float32;
 };
 
-auto createFrameBuffer(int width, int height) -> FrameBuffer;
+auto createFrameBuffer(int width, int height, DepthFormat depth_format = DepthFormat::Float32) -> FrameBuffer;
 
 auto clear(FrameBuffer &fb, cv::Vec3b color) -> void;
+// Only touches the pixels inside `region`, which has to lie within the framebuffer.
+auto clear(FrameBuffer &fb, cv::Vec3b color, cv::Rect const &region) -> void;
 auto setPixel(FrameBuffer &fb, int x, int y, float inv_depth, cv::Vec3b color) -> void;
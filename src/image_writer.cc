@@ -0,0 +1,53 @@
+#include "image_writer.h"
+
+#include <fstream>
+#include <iostream>
+
+ImageWriter::ImageWriter(size_t max_queued) : max_queued_(max_queued), worker_([this] { run(); }) {}
+
+ImageWriter::~ImageWriter() { finish(); }
+
+void ImageWriter::enqueue(std::string path, std::vector<uint8_t> bytes) {
+    auto lock = std::unique_lock{mutex_};
+    not_full_.wait(lock, [this] { return queue_.size() < max_queued_; });
+    queue_.push_back(PendingImage{.path = std::move(path), .bytes = std::move(bytes)});
+    not_empty_.notify_one();
+}
+
+int ImageWriter::finish() {
+    {
+        auto lock = std::lock_guard{mutex_};
+        closed_ = true;
+    }
+    not_empty_.notify_one();
+
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+
+    return failed_writes_;
+}
+
+void ImageWriter::run() {
+    while (true) {
+        auto image = PendingImage{};
+        {
+            auto lock = std::unique_lock{mutex_};
+            not_empty_.wait(lock, [this] { return !queue_.empty() || closed_; });
+            if (queue_.empty()) {
+                return;
+            }
+            image = std::move(queue_.front());
+            queue_.pop_front();
+        }
+        not_full_.notify_one();
+
+        auto output_file = std::ofstream(image.path, std::ios::binary);
+        output_file.write(reinterpret_cast<char const *>(image.bytes.data()), std::ssize(image.bytes));
+        if (!output_file.good()) {
+            std::cerr << "Failed to write image '" << image.path << "'" << std::endl;
+            auto lock = std::lock_guard{mutex_};
+            failed_writes_ += 1;
+        }
+    }
+}
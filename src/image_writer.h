@@ -0,0 +1,42 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Writes already encoded images to disk on a background thread. The queue is bounded, so producers only ever block
+// when the disk can't keep up with them for `max_queued` images in a row.
+class ImageWriter {
+    struct PendingImage {
+        std::string path;
+        std::vector<uint8_t> bytes;
+    };
+
+    size_t max_queued_;
+    std::deque<PendingImage> queue_;
+    bool closed_ = false;
+    int failed_writes_ = 0;
+
+    std::mutex mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+    std::thread worker_;
+
+    void run();
+
+  public:
+    explicit ImageWriter(size_t max_queued);
+    ~ImageWriter();
+
+    ImageWriter(ImageWriter const &) = delete;
+    ImageWriter &operator=(ImageWriter const &) = delete;
+
+    void enqueue(std::string path, std::vector<uint8_t> bytes);
+
+    // Waits for all queued images to be written and returns the number of images that couldn't be saved.
+    int finish();
+};
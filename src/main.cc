@@ -1,13 +1,18 @@
 #include <chrono>
 #include <cmath>
+#include <string_view>
+#include <thread>
 
+#include "arena.h"
+#include "batch.h"
 #include "benchmark.h"
 #include "drawing.h"
 #include "framebuffer.h"
 #include "math.h"
 #include "mesh.h"
+#include "mesh_file.h"
+#include "scene.h"
 #include "transform.h"
-#include "wavefront.h"
 #include "window.h"
 
 namespace {
@@ -28,17 +33,44 @@ auto nowSeconds() -> double {
     return as_nanos.count() * 1.e-9;
 }
 
+auto runBatch(char const *jobs_file, char const *mesh_file) -> int {
+    auto jobs = readCameraJobs(jobs_file);
+    if (!jobs) {
+        std::cerr << "Failed to load the camera jobs from file!" << std::endl;
+        return 1;
+    }
+
+    auto mesh = readMeshFromFile(mesh_file);
+    if (!mesh) {
+        std::cerr << "Failed to load the mesh from file!" << std::endl;
+        return 1;
+    }
+
+    auto num_workers = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    auto stats = renderBatch(*mesh, *jobs, num_workers);
+
+    std::cout << "Rendered " << stats.frames_rendered << " frames on " << num_workers << " threads in "
+              << stats.seconds << " s (" << stats.frames_rendered / stats.seconds << " fps)" << std::endl;
+    std::cout << "Frame arena high-water mark: " << stats.arena_high_water_mark << " bytes" << std::endl;
+    if (stats.frames_failed > 0) {
+        std::cerr << stats.frames_failed << " frames failed" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
 } // namespace
 
 auto main(int argc, char *argv[]) -> int {
-    (void)argc;
-    (void)argv;
+    // Usage: rndr --batch <jobs file> [mesh file]
+    if (argc >= 3 && std::string_view{argv[1]} == "--batch") {
+        return runBatch(argv[2], argc >= 4 ? argv[3] : MESH_FILE);
+    }
 
     auto frame_buffer = createFrameBuffer(WINDOW_WIDTH, WINDOW_HEIGHT);
     auto main_window = Window("Renderer demo");
 
     auto aspect_ratio = WINDOW_WIDTH / static_cast<float>(WINDOW_HEIGHT);
-    auto projection = projectionTransform(70, aspect_ratio);
 
     auto displayed_mesh = readMeshFromFile(MESH_FILE);
     if (!displayed_mesh) {
@@ -46,14 +78,23 @@ auto main(int argc, char *argv[]) -> int {
         return 1;
     }
 
+    auto frame_arena = FrameArena(1);
+
+    auto object_translation = translationTransform(Vec3{0, 0, -100}) * translationTransform(OBJECT_POSITION);
+    auto scene = Scene(cv::Vec3b(255, 200, 200));
+    scene.add(*displayed_mesh, object_translation);
+
+    auto mesh_bounds = boundingSphere(*displayed_mesh);
+    auto const &[center_x, center_y, center_z] = mesh_bounds.center;
+    auto placed_center = Vec4{center_x, center_y, center_z, 1} * object_translation;
+    auto mesh_center = Vec3{placed_center[0], placed_center[1], placed_center[2]};
+
     auto frame_count = 0;
     auto frame_timer = BenchmarkTimer();
 
     while (true) {
         auto time_now = nowSeconds();
 
-        clear(frame_buffer, cv::Vec3b(255, 200, 200));
-
         auto camera_displacement = Vec3{
             static_cast<float>(std::sin(time_now * 0.25463234 + 2.354313)), //
             static_cast<float>(std::sin(time_now * 0.45231456 + 3.4313)),   //
@@ -62,11 +103,15 @@ auto main(int argc, char *argv[]) -> int {
         auto camera_position = OBJECT_POSITION + CAMERA_DISTANCE_FACTOR * camera_displacement;
         auto camera_transform = lookAt(camera_position, OBJECT_POSITION, Vec3{0.0, 0.0, 1.0});
 
-        auto object_translation = translationTransform(Vec3{0, 0, -100}) * translationTransform(OBJECT_POSITION);
-        drawMesh(frame_buffer, *displayed_mesh, object_translation * camera_transform * projection);
+        auto near_plane = fitNearPlane(camera_transform, mesh_center, mesh_bounds.radius);
+
+        scene.setCamera(camera_transform * projectionTransform(70, aspect_ratio, near_plane));
+        scene.render(frame_buffer, frame_arena.forThread(0));
+        frame_arena.reset();
 
         auto key = main_window.showAndGetKey(frame_buffer.render_target);
         if (key == 27) {
+            std::cout << "Frame arena high-water mark: " << frame_arena.highWaterMark() << " bytes" << std::endl;
             break;
         }
 
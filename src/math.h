@@ -1,16 +1,24 @@
 #pragma once
 
 #include <array>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
 #include <ostream>
+#include <span>
+
+#if defined(__SSE__)
+#include <immintrin.h>
+#endif
 
 struct Vec2 {
     float x;
     float y;
 };
 
-auto operator-(Vec2 const &lhs, Vec2 const &rhs) -> Vec2;
+constexpr auto operator-(Vec2 const &lhs, Vec2 const &rhs) -> Vec2 { return Vec2{lhs.x - rhs.x, lhs.y - rhs.y}; }
 
-auto cross(Vec2 const &lhs, Vec2 const &rhs) -> float;
+constexpr auto cross(Vec2 const &lhs, Vec2 const &rhs) -> float { return lhs.x * rhs.y - lhs.y * rhs.x; }
 
 struct Vec3 {
     float x;
@@ -18,25 +26,66 @@ struct Vec3 {
     float z;
 };
 
-auto operator<<(std::ostream &stream, Vec3 const &vec) -> std::ostream &;
+inline auto operator<<(std::ostream &stream, Vec3 const &vec) -> std::ostream & {
+    stream << "{" << vec.x << ", " << vec.y << ", " << vec.z << "}";
+    return stream;
+}
+
+constexpr auto operator+(Vec3 const &lhs, Vec3 const &rhs) -> Vec3 {
+    return Vec3{lhs.x + rhs.x, lhs.y + rhs.y, lhs.z + rhs.z};
+}
+
+constexpr auto operator-(Vec3 const &vec) -> Vec3 {
+    auto const &[x, y, z] = vec;
+    return Vec3{-x, -y, -z};
+}
+
+constexpr auto operator-(Vec3 const &lhs, Vec3 const &rhs) -> Vec3 {
+    return Vec3{lhs.x - rhs.x, lhs.y - rhs.y, lhs.z - rhs.z};
+}
+
+constexpr auto operator*(float scalar, Vec3 const &vec) -> Vec3 {
+    auto const &[x, y, z] = vec;
+    return Vec3{scalar * x, scalar * y, scalar * z};
+}
+
+constexpr auto dot(Vec3 const &lhs, Vec3 const &rhs) -> float { return lhs.x * rhs.x + lhs.y * rhs.y + lhs.z * rhs.z; }
 
-auto operator+(Vec3 const &lhs, Vec3 const &rhs) -> Vec3;
-auto operator-(Vec3 const &vec) -> Vec3;
-auto operator-(Vec3 const &lhs, Vec3 const &rhs) -> Vec3;
-auto operator*(float scalar, Vec3 const &vec) -> Vec3;
+constexpr auto cross(Vec3 const &lhs, Vec3 const &rhs) -> Vec3 {
+    auto const &[x1, y1, z1] = lhs;
+    auto const &[x2, y2, z2] = rhs;
+    return Vec3{
+        y1 * z2 - z1 * y2, //
+        z1 * x2 - x1 * z2, //
+        x1 * y2 - y1 * x2  //
+    };
+}
 
-auto dot(Vec3 const &lhs, Vec3 const &rhs) -> float;
-auto cross(Vec3 const &lhs, Vec3 const &rhs) -> Vec3;
+// Not constexpr, std::sqrt isn't until C++26.
+inline auto norm(Vec3 const &vec) -> float {
+    auto const &[x, y, z] = vec;
+    return std::sqrt(x * x + y * y + z * z);
+}
 
-auto norm(Vec3 const &vec) -> float;
-auto normalize(Vec3 const &vec) -> Vec3;
+inline auto normalize(Vec3 const &vec) -> Vec3 {
+    auto vec_norm = norm(vec);
+    return (vec_norm != 0) ? ((1 / vec_norm) * vec) : Vec3{1, 0, 0};
+}
 
+// Row-major, vectors are rows and get multiplied from the left.
 template <int Rows, int Cols> struct Matrix : public std::array<float, Rows * Cols> {
-    float &at(int row, int col) { return std::array<float, Rows * Cols>::at(row * Rows + col); }
-    float const &at(int row, int col) const { return std::array<float, Rows * Cols>::at(row * Rows + col); }
+    constexpr float &at(int row, int col) {
+        assert(row >= 0 && row < Rows && col >= 0 && col < Cols);
+        return (*this)[row * Cols + col];
+    }
+    constexpr float const &at(int row, int col) const {
+        assert(row >= 0 && row < Rows && col >= 0 && col < Cols);
+        return (*this)[row * Cols + col];
+    }
 };
 
-template <int A, int B, int C> auto operator*(Matrix<A, B> const &lhs, Matrix<B, C> const &rhs) -> Matrix<A, C> {
+template <int A, int B, int C>
+constexpr auto operator*(Matrix<A, B> const &lhs, Matrix<B, C> const &rhs) -> Matrix<A, C> {
     auto result = Matrix<A, C>{};
 
     for (int row = 0; row < A; ++row) {
@@ -66,3 +115,96 @@ template <int A, int B> auto operator<<(std::ostream &stream, Matrix<A, B> const
 
 using Vec4 = Matrix<1, 4>;
 using Mat4 = Matrix<4, 4>;
+
+#if defined(__SSE__)
+namespace detail {
+
+// Computes x * m[0] + y * m[1] + z * m[2] + w * m[3] over the rows of `m`. The additions happen in the same order as
+// in the generic product, so both give bit-identical results.
+inline auto combineRows(__m128 x, __m128 y, __m128 z, __m128 w, Mat4 const &m) -> __m128 {
+    auto result = _mm_mul_ps(x, _mm_loadu_ps(&m[0]));
+    result = _mm_add_ps(result, _mm_mul_ps(y, _mm_loadu_ps(&m[4])));
+    result = _mm_add_ps(result, _mm_mul_ps(z, _mm_loadu_ps(&m[8])));
+    result = _mm_add_ps(result, _mm_mul_ps(w, _mm_loadu_ps(&m[12])));
+    return result;
+}
+
+inline auto rowTimesMat4(float const *row, Mat4 const &m) -> __m128 {
+    return combineRows(_mm_set1_ps(row[0]), _mm_set1_ps(row[1]), _mm_set1_ps(row[2]), _mm_set1_ps(row[3]), m);
+}
+
+} // namespace detail
+#endif
+
+// The two products on the vertex path get SIMD versions, everything else goes through the generic one.
+constexpr auto operator*(Vec4 const &lhs, Mat4 const &rhs) -> Vec4 {
+#if defined(__SSE__)
+    if !consteval {
+        auto result = Vec4{};
+        _mm_storeu_ps(&result[0], detail::rowTimesMat4(&lhs[0], rhs));
+        return result;
+    }
+#endif
+    return operator*<1, 4, 4>(lhs, rhs);
+}
+
+constexpr auto operator*(Mat4 const &lhs, Mat4 const &rhs) -> Mat4 {
+#if defined(__SSE__)
+    if !consteval {
+        auto result = Mat4{};
+        for (int row = 0; row < 4; ++row) {
+            _mm_storeu_ps(&result[4 * row], detail::rowTimesMat4(&lhs[4 * row], rhs));
+        }
+        return result;
+    }
+#endif
+    return operator*<4, 4, 4>(lhs, rhs);
+}
+
+// Transforms a point (with w = 1) and applies the perspective divide. Points with w = 0 end up at the origin.
+constexpr auto transformPoint(Vec3 const &point, Mat4 const &transform) -> Vec3 {
+    auto const &[x, y, z] = point;
+    auto v2 = Vec4{x, y, z, 1} * transform;
+
+    auto const &x2 = v2[0];
+    auto const &y2 = v2[1];
+    auto const &z2 = v2[2];
+    auto const &w2 = v2[3];
+
+    return w2 == 0 ? Vec3{0, 0, 0} : Vec3{x2 / w2, y2 / w2, z2 / w2};
+}
+
+// Batch version of transformPoint over `count` points: `get(i)` returns the i-th point and `set(i, p)` receives the
+// transformed one, so points stored inside bigger structs don't have to be copied out first.
+template <typename Get, typename Set>
+auto transformPoints(int64_t count, Mat4 const &transform, Get &&get, Set &&set) -> void {
+#if defined(__SSE__)
+    auto const one = _mm_set1_ps(1.f);
+    auto const zero = _mm_setzero_ps();
+    for (int64_t i = 0; i < count; ++i) {
+        auto const [x, y, z] = get(i);
+        auto v2 = detail::combineRows(_mm_set1_ps(x), _mm_set1_ps(y), _mm_set1_ps(z), one, transform);
+
+        auto w2 = _mm_shuffle_ps(v2, v2, _MM_SHUFFLE(3, 3, 3, 3));
+        auto projected = _mm_div_ps(v2, w2);
+        projected = _mm_andnot_ps(_mm_cmpeq_ps(w2, zero), projected);
+
+        alignas(16) float result[4];
+        _mm_store_ps(result, projected);
+        set(i, Vec3{result[0], result[1], result[2]});
+    }
+#else
+    for (int64_t i = 0; i < count; ++i) {
+        set(i, transformPoint(get(i), transform));
+    }
+#endif
+}
+
+// `out` must be at least as long as `points`.
+inline auto transformPoints(std::span<Vec3 const> points, Mat4 const &transform, std::span<Vec3> out) -> void {
+    assert(out.size() >= points.size());
+
+    transformPoints(
+        std::ssize(points), transform, [&](int64_t i) { return points[i]; },
+        [&](int64_t i, Vec3 const &point) { out[i] = point; });
+}
@@ -1,6 +1,39 @@
 #include "mesh.h"
 
 #include <algorithm>
+#include <cassert>
+#include <functional>
+
+namespace {
+
+auto deduplicateIndexedVertices(std::vector<IndexedVertex> const &indexed) {
+    auto indices_sorted = indexed;
+    std::ranges::sort(indices_sorted, std::less<IndexedVertex>{});
+
+    auto duplicates = std::ranges::unique(indices_sorted);
+    return std::vector<IndexedVertex>{indices_sorted.begin(), duplicates.begin()};
+}
+
+bool makeVertices(std::vector<IndexedVertex> const &indexed, std::vector<Vec3> const &positions,
+                  std::vector<Vec2> const &texture_coords, std::vector<Vertex> &vertices) {
+    vertices.clear();
+    vertices.reserve(indexed.size());
+
+    for (auto const &[pos_idx, coord_idx] : indexed) {
+        if (pos_idx < 1 || pos_idx > std::ssize(positions))
+            return false;
+
+        if (coord_idx.has_value() && (*coord_idx < 1 || *coord_idx > std::ssize(texture_coords)))
+            return false;
+
+        vertices.push_back(Vertex{.position = positions[pos_idx - 1],
+                                  .texture_coords = coord_idx ? texture_coords[*coord_idx - 1] : Vec2{0.5, 0.5}});
+    }
+
+    return true;
+}
+
+} // namespace
 
 auto isMeshValid(Mesh const &mesh) -> bool {
     if (mesh.indices.size() % 3 != 0)
@@ -9,3 +42,57 @@ auto isMeshValid(Mesh const &mesh) -> bool {
     auto is_index_ok = [n = std::ssize(mesh.vertices)](int index) { return index >= 0 && index < n; };
     return std::ranges::all_of(mesh.indices, is_index_ok);
 }
+
+auto boundingSphere(Mesh const &mesh) -> BoundingSphere {
+    if (mesh.vertices.empty())
+        return BoundingSphere{.center = Vec3{0, 0, 0}, .radius = 0};
+
+    auto min = mesh.vertices.front().position;
+    auto max = min;
+    for (auto const &vertex : mesh.vertices) {
+        auto const &[x, y, z] = vertex.position;
+        min = Vec3{std::min(min.x, x), std::min(min.y, y), std::min(min.z, z)};
+        max = Vec3{std::max(max.x, x), std::max(max.y, y), std::max(max.z, z)};
+    }
+
+    return BoundingSphere{.center = 0.5f * (min + max), .radius = 0.5f * norm(max - min)};
+}
+
+auto operator<(IndexedVertex const &lhs, IndexedVertex const &rhs) -> bool {
+    if (lhs.vertex_idx != rhs.vertex_idx)
+        return lhs.vertex_idx < rhs.vertex_idx;
+
+    if (lhs.coords_idx.has_value() != rhs.coords_idx.has_value())
+        return !lhs.coords_idx.has_value();
+
+    if (lhs.coords_idx.has_value())
+        return lhs.coords_idx.value() < rhs.coords_idx.value();
+
+    return false;
+}
+
+auto operator==(IndexedVertex const &lhs, IndexedVertex const &rhs) -> bool {
+    return (lhs.vertex_idx == rhs.vertex_idx) && (lhs.coords_idx.has_value() == rhs.coords_idx.has_value()) &&
+           (lhs.coords_idx.has_value() ? (lhs.coords_idx.value() == rhs.coords_idx.value()) : true);
+}
+
+bool meshFromIndexedData(std::vector<Vec3> const &vertices, std::vector<Vec2> const &texture_coords,
+                         std::vector<IndexedVertex> const &indexed, Mesh &mesh) {
+    auto deduplicated_indices = deduplicateIndexedVertices(indexed);
+
+    auto final_vertices = std::vector<Vertex>{};
+    if (!makeVertices(deduplicated_indices, vertices, texture_coords, final_vertices))
+        return false;
+
+    auto final_indices = std::vector<int>{};
+    final_indices.reserve(indexed.size());
+    for (auto const &indexed_vertex : indexed) {
+        auto it = std::ranges::lower_bound(deduplicated_indices, indexed_vertex, std::less{});
+        assert(it != deduplicated_indices.end());
+        assert(*it == indexed_vertex);
+        final_indices.push_back(std::distance(deduplicated_indices.begin(), it));
+    }
+
+    mesh = Mesh{.vertices = std::move(final_vertices), .indices = std::move(final_indices)};
+    return true;
+}
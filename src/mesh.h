@@ -1,6 +1,7 @@
 #pragma once
 
 #include <array>
+#include <optional>
 #include <vector>
 
 #include "math.h"
@@ -16,3 +17,25 @@ struct Mesh {
 };
 
 auto isMeshValid(Mesh const &mesh) -> bool;
+
+struct BoundingSphere {
+    Vec3 center;
+    float radius;
+};
+
+// The sphere around the mesh's axis-aligned bounds. Not the tightest one, but cheap and good enough for depth ranges.
+auto boundingSphere(Mesh const &mesh) -> BoundingSphere;
+
+// A corner of a face as it's stored by most mesh formats, indices are 1-based like in OBJ files.
+struct IndexedVertex {
+    int vertex_idx;
+    std::optional<int> coords_idx;
+};
+
+auto operator<(IndexedVertex const &lhs, IndexedVertex const &rhs) -> bool;
+auto operator==(IndexedVertex const &lhs, IndexedVertex const &rhs) -> bool;
+
+// Merges corners that refer to the same position and texture coordinates into one vertex. Fails if any index is out
+// of range.
+bool meshFromIndexedData(std::vector<Vec3> const &vertices, std::vector<Vec2> const &texture_coords,
+                         std::vector<IndexedVertex> const &indexed, Mesh &mesh);
@@ -0,0 +1,92 @@
+#include "mesh_file.h"
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string_view>
+
+#include "ply.h"
+#include "stl.h"
+#include "wavefront.h"
+
+namespace {
+
+enum class MeshFormat { Wavefront, Ply, Stl };
+
+// Long enough for the PLY magic and the STL header with its triangle count.
+constexpr std::streamsize PROBE_SIZE = 84;
+
+auto readProbe(std::string const &path) -> std::optional<std::string> {
+    auto input_file = std::ifstream(path, std::ios::binary);
+    if (!input_file.good())
+        return {};
+
+    auto probe = std::string(PROBE_SIZE, '\0');
+    input_file.read(probe.data(), PROBE_SIZE);
+    probe.resize(input_file.gcount());
+    return probe;
+}
+
+auto lowercaseExtension(std::string const &path) -> std::string {
+    auto extension = std::filesystem::path{path}.extension().string();
+    std::ranges::transform(extension, extension.begin(), [](unsigned char ch) { return std::tolower(ch); });
+    return extension;
+}
+
+auto detectFormat(std::string const &path, std::string_view probe) -> MeshFormat {
+    if (hasPlyMagic(probe))
+        return MeshFormat::Ply;
+
+    auto error = std::error_code{};
+    auto file_size = std::filesystem::file_size(path, error);
+    if (!error && looksLikeBinaryStl(probe, file_size))
+        return MeshFormat::Stl;
+
+    auto extension = lowercaseExtension(path);
+    if (extension == ".ply")
+        return MeshFormat::Ply;
+    if (extension == ".stl")
+        return MeshFormat::Stl;
+
+    return MeshFormat::Wavefront;
+}
+
+} // namespace
+
+auto readFileContents(std::string const &path) -> std::optional<std::string> {
+    auto input_file = std::ifstream(path, std::ios::binary | std::ios::ate);
+    if (!input_file.good())
+        return {};
+
+    auto contents = std::string(static_cast<size_t>(input_file.tellg()), '\0');
+    input_file.seekg(0);
+    input_file.read(contents.data(), std::ssize(contents));
+    if (!input_file.good())
+        return {};
+
+    return contents;
+}
+
+std::optional<Mesh> readMeshFromFile(std::string const &path) {
+    auto probe = readProbe(path);
+    if (!probe) {
+        std::cerr << "Failed to open file '" << path << "'" << std::endl;
+        return {};
+    }
+
+    auto format = detectFormat(path, *probe);
+    if (format == MeshFormat::Wavefront)
+        return readWavefrontFile(path);
+
+    // Binary formats are parsed straight from memory, so read them in one go.
+    auto contents = readFileContents(path);
+    if (!contents) {
+        std::cerr << "Failed to read file '" << path << "'" << std::endl;
+        return {};
+    }
+
+    return format == MeshFormat::Ply ? parsePly(*contents) : parseStl(*contents);
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <optional>
+#include <string>
+
+#include "mesh.h"
+
+// Loads OBJ, binary PLY or binary STL. The format is recognized by its magic bytes where it has them, otherwise by
+// the file extension.
+std::optional<Mesh> readMeshFromFile(std::string const &path);
+
+// The whole file as it is on disk, or nothing if it can't be read. Doesn't print anything, callers report failures.
+auto readFileContents(std::string const &path) -> std::optional<std::string>;
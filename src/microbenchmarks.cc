@@ -0,0 +1,792 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <new>
+#include <optional>
+#include <random>
+#include <span>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "arena.h"
+#include "benchmark.h"
+#include "compact_mesh.h"
+#include "drawing.h"
+#include "framebuffer.h"
+#include "math.h"
+#include "mesh.h"
+#include "mesh_file.h"
+#include "scene.h"
+#include "transform.h"
+#include "wavefront.h"
+
+namespace {
+
+std::atomic<int64_t> heap_allocations{0};
+
+auto countedAllocate(std::size_t size) -> void * {
+    heap_allocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+auto countedAllocate(std::size_t size, std::align_val_t alignment) -> void * {
+    heap_allocations.fetch_add(1, std::memory_order_relaxed);
+    auto align = static_cast<std::size_t>(alignment);
+    return std::aligned_alloc(align, size == 0 ? align : (size + align - 1) / align * align);
+}
+
+template <typename... Alignment> auto countedAllocateOrThrow(std::size_t size, Alignment... alignment) -> void * {
+    if (auto *memory = countedAllocate(size, alignment...)) {
+        return memory;
+    }
+    throw std::bad_alloc{};
+}
+
+} // namespace
+
+// Counts every heap allocation in the process, so that steady-state rendering can be checked for allocations. The
+// array and aligned forms have to be replaced too: sanitizer runtimes supply their own, which never reach the scalar
+// operator new. None of the replacements are inlined, otherwise GCC sees malloc() paired with a delete-expression and
+// warns about mismatched deallocation.
+[[gnu::noinline]] auto operator new(std::size_t size) -> void * { return countedAllocateOrThrow(size); }
+[[gnu::noinline]] auto operator new[](std::size_t size) -> void * { return countedAllocateOrThrow(size); }
+[[gnu::noinline]] auto operator new(std::size_t size, std::align_val_t alignment) -> void * {
+    return countedAllocateOrThrow(size, alignment);
+}
+[[gnu::noinline]] auto operator new[](std::size_t size, std::align_val_t alignment) -> void * {
+    return countedAllocateOrThrow(size, alignment);
+}
+[[gnu::noinline]] auto operator new(std::size_t size, std::nothrow_t const &) noexcept -> void * {
+    return countedAllocate(size);
+}
+[[gnu::noinline]] auto operator new[](std::size_t size, std::nothrow_t const &) noexcept -> void * {
+    return countedAllocate(size);
+}
+
+[[gnu::noinline]] auto operator delete(void *memory) noexcept -> void { std::free(memory); }
+[[gnu::noinline]] auto operator delete(void *memory, std::size_t) noexcept -> void { std::free(memory); }
+[[gnu::noinline]] auto operator delete[](void *memory) noexcept -> void { std::free(memory); }
+[[gnu::noinline]] auto operator delete[](void *memory, std::size_t) noexcept -> void { std::free(memory); }
+[[gnu::noinline]] auto operator delete(void *memory, std::align_val_t) noexcept -> void { std::free(memory); }
+[[gnu::noinline]] auto operator delete(void *memory, std::size_t, std::align_val_t) noexcept -> void {
+    std::free(memory);
+}
+[[gnu::noinline]] auto operator delete[](void *memory, std::align_val_t) noexcept -> void { std::free(memory); }
+[[gnu::noinline]] auto operator delete[](void *memory, std::size_t, std::align_val_t) noexcept -> void {
+    std::free(memory);
+}
+[[gnu::noinline]] auto operator delete(void *memory, std::nothrow_t const &) noexcept -> void { std::free(memory); }
+[[gnu::noinline]] auto operator delete[](void *memory, std::nothrow_t const &) noexcept -> void { std::free(memory); }
+
+namespace {
+
+constexpr char COW_MESH_FILE[] = "../resources/cow-nonormals.obj";
+constexpr char STATUE_MESH_FILE[] = "../resources/12328_Statue_v1_L2.obj";
+constexpr char GOLDEN_IMAGE_DIR[] = "../resources/golden";
+
+auto const BACKGROUND_COLOR = cv::Vec3b(255, 200, 200);
+
+auto const DEPTH_FORMATS = std::array{
+    std::pair{DepthFormat::Float32, "float32"},
+    std::pair{DepthFormat::Unorm16, "unorm16"},
+    std::pair{DepthFormat::Unorm24, "unorm24"},
+};
+
+template <typename T> auto doNotOptimize(T const &value) -> void { asm volatile("" : : "r,m"(value) : "memory"); }
+
+template <typename F> auto measure(std::string_view name, int64_t iterations, F &&body) -> void {
+    body(); // Warm-up
+
+    auto timer = BenchmarkTimer();
+    for (int64_t i = 0; i < iterations; ++i) {
+        body();
+    }
+    auto nanos = timer.GetNanosAndReset();
+
+    std::cout << std::left << std::setw(48) << name << std::right << std::setw(14) << std::fixed
+              << std::setprecision(2) << nanos / static_cast<double>(iterations) << " ns/iter" << std::endl;
+}
+
+// The matrix product as it was before math.h became header-only: out of line, bounds-checked, generic.
+namespace reference {
+
+template <int Rows, int Cols> struct Matrix : public std::array<float, Rows * Cols> {
+    float &at(int row, int col) { return std::array<float, Rows * Cols>::at(row * Rows + col); }
+    float const &at(int row, int col) const { return std::array<float, Rows * Cols>::at(row * Rows + col); }
+};
+
+template <int A, int B, int C>
+[[gnu::noinline]] auto multiply(Matrix<A, B> const &lhs, Matrix<B, C> const &rhs) -> Matrix<A, C> {
+    auto result = Matrix<A, C>{};
+
+    for (int row = 0; row < A; ++row) {
+        for (int col = 0; col < C; ++col) {
+            result.at(row, col) = 0;
+            for (int i = 0; i < B; ++i) {
+                result.at(row, col) += lhs.at(row, i) * rhs.at(i, col);
+            }
+        }
+    }
+
+    return result;
+}
+
+auto transformPoint(Vec3 const &point, Matrix<4, 4> const &transform) -> Vec3 {
+    auto const &[x, y, z] = point;
+    auto v2 = multiply(Matrix<1, 4>{x, y, z, 1}, transform);
+    return v2[3] == 0 ? Vec3{0, 0, 0} : Vec3{v2[0] / v2[3], v2[1] / v2[3], v2[2] / v2[3]};
+}
+
+} // namespace reference
+
+auto makeTransform() -> Mat4 {
+    return lookAt(Vec3{10, 20, 30}, Vec3{0, 0, 0}, Vec3{0, 0, 1}) * projectionTransform(70, 16 / 9.f);
+}
+
+auto makePoints(int count) -> std::vector<Vec3> {
+    auto rng = std::mt19937{1234};
+    auto dist = std::uniform_real_distribution<float>{-10, 10};
+
+    auto points = std::vector<Vec3>{};
+    points.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        points.push_back(Vec3{dist(rng), dist(rng), dist(rng)});
+    }
+    return points;
+}
+
+auto benchmarkMath() -> void {
+    auto const transform = makeTransform();
+    auto reference_transform = reference::Matrix<4, 4>{};
+    std::ranges::copy(transform, reference_transform.begin());
+
+    auto vec = Vec4{1, 2, 3, 1};
+    auto reference_vec = reference::Matrix<1, 4>{1, 2, 3, 1};
+
+    measure("Vec4 x Mat4 (reference)", 10'000'000, [&] {
+        doNotOptimize(reference_vec);
+        doNotOptimize(reference::multiply(reference_vec, reference_transform));
+    });
+    measure("Vec4 x Mat4", 10'000'000, [&] {
+        doNotOptimize(vec);
+        doNotOptimize(vec * transform);
+    });
+
+    measure("Mat4 x Mat4 (reference)", 1'000'000, [&] {
+        doNotOptimize(reference_transform);
+        doNotOptimize(reference::multiply(reference_transform, reference_transform));
+    });
+    measure("Mat4 x Mat4", 1'000'000, [&] {
+        doNotOptimize(transform);
+        doNotOptimize(transform * transform);
+    });
+
+    auto const points = makePoints(100'000);
+    auto transformed = std::vector<Vec3>(points.size());
+
+    measure("Transform 100k points (reference)", 100, [&] {
+        for (size_t i = 0; i < points.size(); ++i) {
+            transformed[i] = reference::transformPoint(points[i], reference_transform);
+        }
+        doNotOptimize(transformed.data());
+    });
+    measure("Transform 100k points (transformPoint)", 100, [&] {
+        for (size_t i = 0; i < points.size(); ++i) {
+            transformed[i] = transformPoint(points[i], transform);
+        }
+        doNotOptimize(transformed.data());
+    });
+    measure("Transform 100k points (transformPoints)", 100, [&] {
+        transformPoints(points, transform, transformed);
+        doNotOptimize(transformed.data());
+    });
+}
+
+// The OBJ parser reports every line it skips, which would drown out the results.
+class SilenceStderr {
+    std::streambuf *original_;
+
+  public:
+    SilenceStderr() : original_(std::cerr.rdbuf(nullptr)) {}
+    ~SilenceStderr() {
+        std::cerr.rdbuf(original_);
+        std::cerr.clear();
+    }
+};
+
+auto loadMeshQuietly(char const *path) -> std::optional<Mesh> {
+    auto mesh = std::invoke([path] {
+        auto silence = SilenceStderr();
+        return readMeshFromFile(path);
+    });
+
+    if (!mesh) {
+        std::cerr << "Failed to load the mesh from '" << path << "'" << std::endl;
+    }
+    return mesh;
+}
+
+auto benchmarkLoading(std::string_view name, std::string const &path, int64_t iterations) -> void {
+    auto contents = readFileContents(path);
+    if (!contents) {
+        std::cerr << "Failed to read file '" << path << "'" << std::endl;
+        return;
+    }
+
+    auto silence = SilenceStderr();
+
+    auto data = WavefrontData{};
+    measure(std::string{"Parse OBJ ("} + std::string{name} + ")", iterations, [&] {
+        auto stream = std::istringstream{*contents};
+        data = parseWavefront(stream);
+    });
+
+    auto mesh = Mesh{};
+    measure(std::string{"meshFromIndexedData ("} + std::string{name} + ")", iterations, [&] {
+        meshFromIndexedData(data.vertices, data.texture_coords, data.indexed, mesh);
+        doNotOptimize(mesh.vertices.data());
+    });
+}
+
+template <typename T> auto writeScalar(std::ostream &stream, T value, std::endian byte_order) -> void {
+    auto bits = std::bit_cast<std::array<char, sizeof(T)>>(value);
+    if (byte_order != std::endian::native) {
+        std::ranges::reverse(bits);
+    }
+    stream.write(bits.data(), bits.size());
+}
+
+// Writes `mesh` with the axes flipped back, the way the importers expect files on disk.
+auto writeBinaryPly(std::filesystem::path const &path, Mesh const &mesh, std::endian byte_order) -> void {
+    auto output_file = std::ofstream(path, std::ios::binary);
+    output_file << "ply\nformat " << (byte_order == std::endian::little ? "binary_little_endian" : "binary_big_endian")
+                << " 1.0\n"
+                << "element vertex " << mesh.vertices.size() << "\n"
+                << "property float x\nproperty float y\nproperty float z\nproperty float u\nproperty float v\n"
+                << "element face " << mesh.indices.size() / 3 << "\n"
+                << "property list uchar int vertex_indices\nend_header\n";
+
+    for (auto const &[position, texture_coords] : mesh.vertices) {
+        for (auto value : {-position.x, -position.y, position.z, texture_coords.x, texture_coords.y}) {
+            writeScalar(output_file, value, byte_order);
+        }
+    }
+    for (size_t i = 0; i < mesh.indices.size(); i += 3) {
+        writeScalar(output_file, uint8_t{3}, byte_order);
+        for (size_t j = 0; j < 3; ++j) {
+            writeScalar(output_file, mesh.indices[i + j], byte_order);
+        }
+    }
+}
+
+auto writeBinaryStl(std::filesystem::path const &path, Mesh const &mesh) -> void {
+    auto output_file = std::ofstream(path, std::ios::binary);
+    auto header = std::array<char, 80>{};
+    auto triangle_count = static_cast<uint32_t>(mesh.indices.size() / 3);
+    output_file.write(header.data(), header.size());
+    output_file.write(reinterpret_cast<char const *>(&triangle_count), sizeof(triangle_count));
+
+    for (size_t i = 0; i < mesh.indices.size(); i += 3) {
+        auto record = std::array<float, 12>{};
+        for (size_t j = 0; j < 3; ++j) {
+            auto const &position = mesh.vertices[mesh.indices[i + j]].position;
+            record[3 + 3 * j] = -position.x;
+            record[4 + 3 * j] = -position.y;
+            record[5 + 3 * j] = position.z;
+        }
+        auto attributes = uint16_t{0};
+        output_file.write(reinterpret_cast<char const *>(record.data()), sizeof(record));
+        output_file.write(reinterpret_cast<char const *>(&attributes), sizeof(attributes));
+    }
+}
+
+// The same mesh from each supported format, including opening and reading the file.
+auto benchmarkFormats() -> void {
+    auto mesh = loadMeshQuietly(STATUE_MESH_FILE);
+    if (!mesh) {
+        return;
+    }
+
+    auto directory = std::filesystem::temp_directory_path();
+    auto ply_path = directory / "rndr-bench-statue.ply";
+    auto stl_path = directory / "rndr-bench-statue.stl";
+    writeBinaryPly(ply_path, *mesh, std::endian::little);
+    writeBinaryStl(stl_path, *mesh);
+
+    auto loaded = std::optional<Mesh>{};
+    measure("readMeshFromFile (statue, OBJ)", 3, [&] { loaded = loadMeshQuietly(STATUE_MESH_FILE); });
+    measure("readMeshFromFile (statue, binary PLY)", 10, [&] { loaded = readMeshFromFile(ply_path.string()); });
+    measure("readMeshFromFile (statue, binary STL)", 10, [&] { loaded = readMeshFromFile(stl_path.string()); });
+
+    std::filesystem::remove(ply_path);
+    std::filesystem::remove(stl_path);
+}
+
+// Compares the triangles of two meshes corner by corner, so it doesn't depend on the order vertices were merged in.
+auto haveSameTriangles(Mesh const &expected, Mesh const &actual, bool compare_coords) -> bool {
+    if (expected.indices.size() != actual.indices.size())
+        return false;
+
+    for (size_t i = 0; i < expected.indices.size(); ++i) {
+        auto const &[expected_position, expected_coords] = expected.vertices[expected.indices[i]];
+        auto const &[actual_position, actual_coords] = actual.vertices[actual.indices[i]];
+
+        if (expected_position.x != actual_position.x || expected_position.y != actual_position.y ||
+            expected_position.z != actual_position.z)
+            return false;
+        if (compare_coords && (expected_coords.x != actual_coords.x || expected_coords.y != actual_coords.y))
+            return false;
+    }
+    return true;
+}
+
+auto countDistinctPositions(Mesh const &mesh) -> size_t {
+    auto positions = std::vector<std::array<uint32_t, 3>>{};
+    for (auto index : mesh.indices) {
+        auto const &[x, y, z] = mesh.vertices[index].position;
+        positions.push_back({std::bit_cast<uint32_t>(x), std::bit_cast<uint32_t>(y), std::bit_cast<uint32_t>(z)});
+    }
+    std::ranges::sort(positions);
+    return std::distance(positions.begin(), std::ranges::unique(positions).begin());
+}
+
+// Writes the cow in every binary format and checks that reading it back gives the same mesh as the OBJ file. STL has
+// no texture coordinates, but its merged positions still have to match one-to-one.
+auto checkMeshFormats() -> bool {
+    auto mesh = loadMeshQuietly(COW_MESH_FILE);
+    if (!mesh) {
+        return false;
+    }
+
+    auto directory = std::filesystem::temp_directory_path();
+    auto ply_le_path = directory / "rndr-bench-cow-le.ply";
+    auto ply_be_path = directory / "rndr-bench-cow-be.ply";
+    auto stl_path = directory / "rndr-bench-cow.stl";
+    writeBinaryPly(ply_le_path, *mesh, std::endian::little);
+    writeBinaryPly(ply_be_path, *mesh, std::endian::big);
+    writeBinaryStl(stl_path, *mesh);
+
+    auto check = [&](std::string_view name, std::filesystem::path const &path, bool is_stl) {
+        auto loaded = loadMeshQuietly(path.string().c_str());
+        auto same = loaded && haveSameTriangles(*mesh, *loaded, !is_stl) &&
+                    loaded->vertices.size() == (is_stl ? countDistinctPositions(*mesh) : mesh->vertices.size());
+        std::cout << "Round trip through " << name << ": " << (same ? "same mesh" : "MISMATCH") << std::endl;
+        std::filesystem::remove(path);
+        return same;
+    };
+
+    auto ok = check("little-endian PLY", ply_le_path, false);
+    ok = check("big-endian PLY", ply_be_path, false) && ok;
+    ok = check("binary STL", stl_path, true) && ok;
+    return ok;
+}
+
+auto benchmarkVertexTransform() -> void {
+    auto mesh = loadMeshQuietly(STATUE_MESH_FILE);
+    if (!mesh) {
+        return;
+    }
+
+    auto const transform = makeTransform();
+    auto scratch = LinearArena();
+    auto transformed = scratch.allocate<Vertex>(mesh->vertices.size());
+
+    auto name = "Transform " + std::to_string(mesh->vertices.size()) + " statue vertices";
+    measure(name, 100, [&] {
+        transformVertices(mesh->vertices, transform, transformed);
+        doNotOptimize(transformed.data());
+    });
+
+    auto compact = compressMesh(*mesh);
+    measure(name + " (compact)", 100, [&] {
+        for (auto const &cluster : compact.clusters) {
+            auto vertices = std::span{compact.vertices}.subspan(cluster.first_vertex, cluster.vertex_count);
+            transformVertices(vertices, cluster, transform, transformed);
+        }
+        doNotOptimize(transformed.data());
+    });
+}
+
+auto countDifferentPixels(cv::Mat const &lhs, cv::Mat const &rhs) -> int64_t {
+    auto count = int64_t{0};
+    for (int y = 0; y < lhs.rows; ++y) {
+        for (int x = 0; x < lhs.cols; ++x) {
+            count += lhs.at<cv::Vec3b>(y, x) != rhs.at<cv::Vec3b>(y, x);
+        }
+    }
+    return count;
+}
+
+// Also renders the statue split into many small clusters. They all share one quantization grid, so that has to give
+// exactly the same image as a single cluster; returns false if it doesn't.
+auto benchmarkCompactMesh() -> bool {
+    auto mesh = loadMeshQuietly(STATUE_MESH_FILE);
+    if (!mesh) {
+        return false;
+    }
+
+    auto compact = CompactMesh{};
+    measure("compressMesh (statue)", 10, [&] { compact = compressMesh(*mesh); });
+    auto clustered = compressMesh(*mesh, 4096);
+
+    std::cout << "Statue mesh: " << memoryFootprint(*mesh) << " bytes, compact: " << memoryFootprint(compact)
+              << " bytes in " << compact.clusters.size() << " clusters" << std::endl;
+
+    auto fb = createFrameBuffer(1920, 1080);
+    auto compact_fb = createFrameBuffer(1920, 1080);
+    auto clustered_fb = createFrameBuffer(1920, 1080);
+    auto scratch = LinearArena();
+    auto transform = lookAt(Vec3{150, 20, 40}, Vec3{0, 0, 30}, Vec3{0, 0, 1}) * projectionTransform(70, 16 / 9.f);
+
+    measure("drawMesh (statue)", 20, [&] {
+        clear(fb, BACKGROUND_COLOR);
+        drawMesh(fb, *mesh, transform, scratch);
+        scratch.reset();
+    });
+    measure("drawMesh (statue, compact)", 20, [&] {
+        clear(compact_fb, BACKGROUND_COLOR);
+        drawMesh(compact_fb, compact, transform, scratch);
+        scratch.reset();
+    });
+    measure("drawMesh (statue, compact, " + std::to_string(clustered.clusters.size()) + " clusters)", 20, [&] {
+        clear(clustered_fb, BACKGROUND_COLOR);
+        drawMesh(clustered_fb, clustered, transform, scratch);
+        scratch.reset();
+    });
+
+    auto clustered_differences = countDifferentPixels(compact_fb.render_target, clustered_fb.render_target);
+    std::cout << "Compact statue differs in " << countDifferentPixels(fb.render_target, compact_fb.render_target)
+              << " pixels, " << countDifferentPixels(fb.render_target, clustered_fb.render_target)
+              << " pixels with " << clustered.clusters.size() << " clusters (" << clustered_differences
+              << " pixels from a single cluster)" << std::endl;
+    return clustered_differences == 0;
+}
+
+// Right triangle with both legs `size` pixels long, facing the camera.
+auto makeScreenTriangle(cv::Mat const &img, float size) -> Triangle {
+    auto half = Vec2((img.cols - 1) / 2.f, (img.rows - 1) / 2.f);
+    auto to_clip_space = [&](float x, float y) {
+        return Vertex{.position = Vec3{(x - half.x) / half.x, (y - half.y) / half.y, 0.5}, .texture_coords = {0, 0}};
+    };
+
+    auto x = std::max(half.x - size / 2, 0.f);
+    auto y = std::max(half.y - size / 2, 0.f);
+    return Triangle{to_clip_space(x, y), to_clip_space(x, y + size), to_clip_space(x + size, y)};
+}
+
+auto benchmarkRasterization() -> void {
+    auto fb = createFrameBuffer(1920, 1080);
+
+    auto full_screen = Triangle{
+        Vertex{.position = Vec3{-1, -1, 0.5}, .texture_coords = {0, 0}},
+        Vertex{.position = Vec3{-1, 3, 0.5}, .texture_coords = {0, 2}},
+        Vertex{.position = Vec3{3, -1, 0.5}, .texture_coords = {2, 0}},
+    };
+
+    struct Case {
+        std::string name;
+        Triangle triangle;
+        int64_t iterations;
+    };
+    auto cases = std::vector<Case>{};
+    for (auto size : {0.5f, 1.f, 4.f, 16.f, 64.f, 256.f, 1024.f}) {
+        auto iterations = std::max(int64_t{10}, static_cast<int64_t>(1'000'000 / (1 + size * size)));
+        auto name = std::ostringstream{};
+        name << "drawTriangle (" << size << " px)";
+        cases.push_back(Case{.name = name.str(),
+                             .triangle = makeScreenTriangle(fb.render_target, size),
+                             .iterations = iterations});
+    }
+    cases.push_back(Case{.name = "drawTriangle (full screen)", .triangle = full_screen, .iterations = 10});
+
+    for (auto const &[name, triangle, iterations] : cases) {
+        // Bring each draw a bit closer, so that the depth test never rejects it.
+        auto drawn = triangle;
+        measure(name, iterations, [&] {
+            for (auto &vertex : drawn) {
+                vertex.position.z *= 1.000001f;
+            }
+            drawTriangle(fb, drawn);
+        });
+        clear(fb, BACKGROUND_COLOR);
+    }
+}
+
+auto benchmarkClear() -> void {
+    for (auto const &[format, format_name] : DEPTH_FORMATS) {
+        auto fb = createFrameBuffer(1920, 1080, format);
+        measure(std::string{"clear (1920x1080, "} + format_name + ")", 100, [&] { clear(fb, BACKGROUND_COLOR); });
+    }
+}
+
+// Once the frame arena has grown to fit a frame, rendering more frames of the same scene mustn't allocate.
+auto checkSteadyStateAllocations() -> bool {
+    auto mesh = loadMeshQuietly(COW_MESH_FILE);
+    if (!mesh) {
+        return false;
+    }
+
+    auto fb = createFrameBuffer(640, 360);
+    auto frame_arena = FrameArena(1);
+    auto projection = projectionTransform(70, 640 / 360.f);
+
+    auto render_frame = [&](int frame) {
+        auto eye = Vec3{10.f * std::sin(frame * 0.1f), 10.f * std::cos(frame * 0.1f), 3};
+        clear(fb, BACKGROUND_COLOR);
+        drawMesh(fb, *mesh, lookAt(eye, Vec3{0, 0, 0}, Vec3{0, 0, 1}) * projection, frame_arena.forThread(0));
+        frame_arena.reset();
+    };
+
+    constexpr auto WARM_UP_FRAMES = 3;
+    constexpr auto MEASURED_FRAMES = 20;
+
+    for (int frame = 0; frame < WARM_UP_FRAMES; ++frame) {
+        render_frame(frame);
+    }
+
+    auto allocations_before = heap_allocations.load();
+    for (int frame = WARM_UP_FRAMES; frame < WARM_UP_FRAMES + MEASURED_FRAMES; ++frame) {
+        render_frame(frame);
+    }
+    auto allocations = heap_allocations.load() - allocations_before;
+
+    std::cout << "Heap allocations in " << MEASURED_FRAMES << " steady-state frames: " << allocations
+              << " (frame arena high-water mark: " << frame_arena.highWaterMark() << " bytes)" << std::endl;
+    return allocations == 0;
+}
+
+struct GoldenView {
+    std::string name;
+    char const *mesh_file;
+    Vec3 eye;
+    Vec3 at;
+    Vec3 up;
+};
+
+auto const GOLDEN_VIEWS = std::array{
+    GoldenView{"statue-0", STATUE_MESH_FILE, Vec3{150, 20, 40}, Vec3{0, 0, 30}, Vec3{0, 0, 1}},
+    GoldenView{"statue-1", STATUE_MESH_FILE, Vec3{-80, 120, 60}, Vec3{0, 0, 30}, Vec3{0, 0, 1}},
+    GoldenView{"statue-2", STATUE_MESH_FILE, Vec3{10, -140, -30}, Vec3{0, 0, 30}, Vec3{0, 0, 1}},
+    GoldenView{"cow-0", COW_MESH_FILE, Vec3{7.5, 1, 2}, Vec3{0, 0, 0}, Vec3{0, 1, 0}},
+    GoldenView{"cow-1", COW_MESH_FILE, Vec3{-4, 6, 3}, Vec3{0, 0, 0}, Vec3{0, 1, 0}},
+    GoldenView{"cow-2", COW_MESH_FILE, Vec3{0.5, -7, -1.5}, Vec3{0, 0, 0}, Vec3{0, 1, 0}},
+};
+
+auto loadViewMeshes() -> std::optional<std::map<std::string, Mesh>> {
+    auto meshes = std::map<std::string, Mesh>{};
+    for (auto const &view : GOLDEN_VIEWS) {
+        if (!meshes.contains(view.mesh_file)) {
+            auto mesh = loadMeshQuietly(view.mesh_file);
+            if (!mesh) {
+                return {};
+            }
+            meshes.emplace(view.mesh_file, std::move(*mesh));
+        }
+    }
+    return meshes;
+}
+
+// Renders fixed views of the bundled meshes and compares them pixel by pixel with the images in `golden_dir`. With
+// `update`, the references are overwritten instead.
+auto checkGoldenImages(std::filesystem::path const &golden_dir, bool update) -> bool {
+    auto fb = createFrameBuffer(640, 360);
+    auto scratch = LinearArena();
+    auto projection = projectionTransform(70, 640 / 360.f);
+
+    if (update) {
+        std::filesystem::create_directories(golden_dir);
+    }
+
+    auto meshes = loadViewMeshes();
+    if (!meshes) {
+        return false;
+    }
+
+    auto all_match = true;
+    for (auto const &view : GOLDEN_VIEWS) {
+        clear(fb, BACKGROUND_COLOR);
+        drawMesh(fb, meshes->at(view.mesh_file), lookAt(view.eye, view.at, view.up) * projection, scratch);
+        scratch.reset();
+
+        auto path = (golden_dir / (view.name + ".png")).string();
+        if (update) {
+            if (!cv::imwrite(path, fb.render_target)) {
+                std::cerr << "Failed to write image '" << path << "'" << std::endl;
+                all_match = false;
+            }
+            continue;
+        }
+
+        auto reference = cv::imread(path, cv::IMREAD_COLOR);
+        if (reference.empty()) {
+            std::cerr << "Missing golden image '" << path << "', run with --update-golden to create it" << std::endl;
+            all_match = false;
+            continue;
+        }
+
+        if (reference.size() != fb.render_target.size()) {
+            std::cerr << "Golden image '" << path << "' has a different size" << std::endl;
+            all_match = false;
+            continue;
+        }
+
+        auto different_pixels = countDifferentPixels(reference, fb.render_target);
+        std::cout << "Golden image " << view.name << ": " << different_pixels << " different pixels" << std::endl;
+        all_match = all_match && different_pixels == 0;
+    }
+
+    return all_match;
+}
+
+// Renders the golden views with every depth format and reports how far each one is from the float32 result and how
+// big its depth buffer is, to show which scenes get away with fewer bits and what that saves.
+auto benchmarkDepthFormats() -> void {
+    auto meshes = loadViewMeshes();
+    if (!meshes) {
+        return;
+    }
+
+    auto scratch = LinearArena();
+    auto reference = createFrameBuffer(1920, 1080);
+
+    for (auto const &view : GOLDEN_VIEWS) {
+        auto const &mesh = meshes->at(view.mesh_file);
+
+        // The default near plane of 1 is far in front of most views, which would waste most of the unorm range on
+        // empty space in front of the mesh.
+        auto camera = lookAt(view.eye, view.at, view.up);
+        auto bounds = boundingSphere(mesh);
+        auto near_plane = fitNearPlane(camera, bounds.center, bounds.radius);
+        auto transform = camera * projectionTransform(70, 1920 / 1080.f, near_plane);
+
+        clear(reference, BACKGROUND_COLOR);
+        drawMesh(reference, mesh, transform, scratch);
+        scratch.reset();
+
+        for (auto const &[format, format_name] : DEPTH_FORMATS) {
+            auto fb = createFrameBuffer(1920, 1080, format);
+            measure("drawMesh (" + view.name + ", " + format_name + ")", 5, [&] {
+                clear(fb, BACKGROUND_COLOR);
+                drawMesh(fb, mesh, transform, scratch);
+                scratch.reset();
+            });
+
+            auto depth_bytes = fb.render_target.total() * depthBytesPerPixel(format);
+            std::cout << "    near plane " << near_plane << ", "
+                      << countDifferentPixels(reference.render_target, fb.render_target)
+                      << " pixels differ from float32, " << depth_bytes << " depth buffer bytes per frame" << std::endl;
+        }
+    }
+}
+
+constexpr auto KIOSK_COLUMNS = 4;
+constexpr auto KIOSK_ROWS = 3;
+
+// A kiosk-like scene: a grid of cows of which only the first one moves.
+auto kioskCowTransform(int cow, int frame) -> Mat4 {
+    auto position = Vec3{12.f * (cow % KIOSK_COLUMNS) - 18.f, 0, 12.f * (cow / KIOSK_COLUMNS) - 12.f};
+    auto bob = cow == 0 ? std::sin(frame * 0.3f) : 0.f;
+    return translationTransform(position + Vec3{0, bob, 0});
+}
+
+// Compares redrawing only what changed with redrawing everything, and checks that both give the same image.
+auto checkIncrementalRendering() -> bool {
+    auto mesh = loadMeshQuietly(COW_MESH_FILE);
+    if (!mesh) {
+        return false;
+    }
+
+    auto camera = lookAt(Vec3{0, 25, 40}, Vec3{0, 0, 0}, Vec3{0, 1, 0}) * projectionTransform(70, 1920 / 1080.f);
+    auto scratch = LinearArena();
+
+    auto fb = createFrameBuffer(1920, 1080);
+    auto scene = Scene(BACKGROUND_COLOR);
+    scene.setCamera(camera);
+    for (int cow = 0; cow < KIOSK_COLUMNS * KIOSK_ROWS; ++cow) {
+        scene.add(*mesh, kioskCowTransform(cow, 0));
+    }
+
+    auto frame = 0;
+    measure("Scene::render (kiosk, one cow moving)", 20, [&] {
+        ++frame;
+        scene.setTransform(0, kioskCowTransform(0, frame));
+        scene.render(fb, scratch);
+        scratch.reset();
+    });
+
+    auto redrew_idle_frame = false;
+    measure("Scene::render (kiosk, nothing moving)", 1000, [&] {
+        redrew_idle_frame = scene.render(fb, scratch) || redrew_idle_frame;
+        scratch.reset();
+    });
+
+    auto reference = createFrameBuffer(1920, 1080);
+    measure("full redraw (kiosk)", 5, [&] {
+        clear(reference, BACKGROUND_COLOR);
+        for (int cow = 0; cow < KIOSK_COLUMNS * KIOSK_ROWS; ++cow) {
+            drawMesh(reference, *mesh, kioskCowTransform(cow, frame) * camera, scratch);
+        }
+        scratch.reset();
+    });
+
+    auto different_pixels = countDifferentPixels(reference.render_target, fb.render_target);
+    std::cout << "    " << different_pixels << " pixels differ from a full redraw" << std::endl;
+    if (redrew_idle_frame) {
+        std::cout << "    Scene::render redrew a frame in which nothing changed" << std::endl;
+    }
+
+    return different_pixels == 0 && !redrew_idle_frame;
+}
+
+} // namespace
+
+// Usage: rndr-bench [--update-golden] [--golden-dir <dir>]
+auto main(int argc, char *argv[]) -> int {
+    auto update_golden = false;
+    auto golden_dir = std::filesystem::path{GOLDEN_IMAGE_DIR};
+
+    for (int i = 1; i < argc; ++i) {
+        auto arg = std::string_view{argv[i]};
+        if (arg == "--update-golden") {
+            update_golden = true;
+        } else if (arg == "--golden-dir" && i + 1 < argc) {
+            golden_dir = argv[++i];
+        } else {
+            std::cerr << "Unknown argument '" << arg << "'" << std::endl;
+            return 1;
+        }
+    }
+
+    if (update_golden) {
+        return checkGoldenImages(golden_dir, true) ? 0 : 1;
+    }
+
+    benchmarkMath();
+    benchmarkLoading("cow", COW_MESH_FILE, 10);
+    benchmarkLoading("statue", STATUE_MESH_FILE, 3);
+    benchmarkFormats();
+    benchmarkVertexTransform();
+    auto ok = benchmarkCompactMesh();
+    benchmarkRasterization();
+    benchmarkClear();
+    benchmarkDepthFormats();
+
+    ok = checkSteadyStateAllocations() && ok;
+    ok = checkGoldenImages(golden_dir, false) && ok;
+    ok = checkMeshFormats() && ok;
+    ok = checkIncrementalRendering() && ok;
+    return ok ? 0 : 1;
+}
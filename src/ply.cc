@@ -0,0 +1,494 @@
+#include "ply.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+enum class ScalarType { Int8, Uint8, Int16, Uint16, Int32, Uint32, Float32, Float64 };
+
+auto parseScalarType(std::string const &name) -> std::optional<ScalarType> {
+    if (name == "char" || name == "int8")
+        return ScalarType::Int8;
+    if (name == "uchar" || name == "uint8")
+        return ScalarType::Uint8;
+    if (name == "short" || name == "int16")
+        return ScalarType::Int16;
+    if (name == "ushort" || name == "uint16")
+        return ScalarType::Uint16;
+    if (name == "int" || name == "int32")
+        return ScalarType::Int32;
+    if (name == "uint" || name == "uint32")
+        return ScalarType::Uint32;
+    if (name == "float" || name == "float32")
+        return ScalarType::Float32;
+    if (name == "double" || name == "float64")
+        return ScalarType::Float64;
+    return {};
+}
+
+auto scalarSize(ScalarType type) -> size_t {
+    switch (type) {
+    case ScalarType::Int8:
+    case ScalarType::Uint8:
+        return 1;
+    case ScalarType::Int16:
+    case ScalarType::Uint16:
+        return 2;
+    case ScalarType::Int32:
+    case ScalarType::Uint32:
+    case ScalarType::Float32:
+        return 4;
+    case ScalarType::Float64:
+        return 8;
+    }
+    return 0;
+}
+
+struct Property {
+    std::string name;
+    ScalarType type;
+    // Set for list properties, where `type` is the type of the items.
+    std::optional<ScalarType> count_type;
+};
+
+struct Element {
+    std::string name;
+    size_t count;
+    std::vector<Property> properties;
+};
+
+struct Header {
+    bool big_endian;
+    std::vector<Element> elements;
+    size_t payload_offset;
+};
+
+auto parseHeader(std::string_view contents) -> std::optional<Header> {
+    auto end_marker = contents.find("end_header");
+    if (end_marker == std::string_view::npos)
+        return {};
+
+    auto payload_offset = contents.find('\n', end_marker);
+    if (payload_offset == std::string_view::npos)
+        return {};
+
+    auto header = Header{.big_endian = false, .elements = {}, .payload_offset = payload_offset + 1};
+    auto has_format = false;
+
+    auto stream = std::istringstream{std::string{contents.substr(0, end_marker)}};
+    for (std::string line; std::getline(stream, line);) {
+        auto line_stream = std::istringstream{line};
+        std::string keyword;
+        line_stream >> keyword;
+
+        if (keyword.empty() || keyword == "ply" || keyword == "comment" || keyword == "obj_info")
+            continue;
+
+        if (keyword == "format") {
+            std::string format;
+            line_stream >> format;
+            if (format == "binary_little_endian") {
+                header.big_endian = false;
+            } else if (format == "binary_big_endian") {
+                header.big_endian = true;
+            } else {
+                std::cerr << "Unsupported PLY format '" << format << "'" << std::endl;
+                return {};
+            }
+            has_format = true;
+        } else if (keyword == "element") {
+            auto element = Element{};
+            line_stream >> element.name >> element.count;
+            if (line_stream.fail())
+                return {};
+            header.elements.push_back(std::move(element));
+        } else if (keyword == "property") {
+            if (header.elements.empty())
+                return {};
+
+            std::string type_name;
+            line_stream >> type_name;
+
+            auto property = Property{};
+            if (type_name == "list") {
+                std::string count_type_name, item_type_name;
+                line_stream >> count_type_name >> item_type_name;
+                property.count_type = parseScalarType(count_type_name);
+                auto item_type = parseScalarType(item_type_name);
+                if (!property.count_type || !item_type)
+                    return {};
+                property.type = *item_type;
+            } else {
+                auto type = parseScalarType(type_name);
+                if (!type)
+                    return {};
+                property.type = *type;
+            }
+
+            line_stream >> property.name;
+            if (line_stream.fail())
+                return {};
+            header.elements.back().properties.push_back(std::move(property));
+        } else {
+            std::cerr << "Skipping PLY header line '" << line << "'" << std::endl;
+        }
+    }
+
+    if (!has_format)
+        return {};
+
+    return header;
+}
+
+// Anything that doesn't fit in an int can't be a valid count or index anyway.
+auto toInt(double value) -> std::optional<int> {
+    if (!(value >= 0 && value < std::numeric_limits<int>::max()))
+        return {};
+    return static_cast<int>(value);
+}
+
+class PayloadReader {
+    std::string_view payload_;
+    size_t offset_ = 0;
+    bool swap_bytes_;
+
+    template <typename T> auto read() -> T {
+        auto bits = std::array<char, sizeof(T)>{};
+        std::memcpy(bits.data(), payload_.data() + offset_, sizeof(T));
+        if (swap_bytes_) {
+            std::ranges::reverse(bits);
+        }
+        offset_ += sizeof(T);
+        return std::bit_cast<T>(bits);
+    }
+
+  public:
+    PayloadReader(std::string_view payload, bool big_endian)
+        : payload_(payload), swap_bytes_(big_endian != (std::endian::native == std::endian::big)) {}
+
+    auto canRead(size_t size) const -> bool { return payload_.size() - offset_ >= size; }
+    auto canRead(size_t count, size_t size) const -> bool { return count <= (payload_.size() - offset_) / size; }
+
+    auto skip(size_t size) -> void { offset_ += size; }
+    auto swapsBytes() const -> bool { return swap_bytes_; }
+    auto rest() const -> std::string_view { return payload_.substr(offset_); }
+
+    // Returns the next `size` bytes as they are and moves past them. Callers have to check canRead(size) first.
+    auto take(size_t size) -> std::string_view {
+        auto bytes = payload_.substr(offset_, size);
+        offset_ += size;
+        return bytes;
+    }
+
+    // Callers have to check canRead(scalarSize(type)) first.
+    auto readScalar(ScalarType type) -> double {
+        switch (type) {
+        case ScalarType::Int8:
+            return read<int8_t>();
+        case ScalarType::Uint8:
+            return read<uint8_t>();
+        case ScalarType::Int16:
+            return read<int16_t>();
+        case ScalarType::Uint16:
+            return read<uint16_t>();
+        case ScalarType::Int32:
+            return read<int32_t>();
+        case ScalarType::Uint32:
+            return read<uint32_t>();
+        case ScalarType::Float32:
+            return read<float>();
+        case ScalarType::Float64:
+            return read<double>();
+        }
+        return 0;
+    }
+};
+
+auto findProperty(Element const &element, std::initializer_list<std::string_view> names) -> int {
+    for (auto name : names) {
+        auto it = std::ranges::find(element.properties, name, &Property::name);
+        if (it != element.properties.end())
+            return static_cast<int>(std::distance(element.properties.begin(), it));
+    }
+    return -1;
+}
+
+auto isFixedSize(Element const &element) -> bool {
+    return std::ranges::none_of(element.properties, [](Property const &p) { return p.count_type.has_value(); });
+}
+
+template <typename T, bool SwapBytes> auto readRaw(char const *data) -> T {
+    auto bits = std::array<char, sizeof(T)>{};
+    std::memcpy(bits.data(), data, sizeof(T));
+    if constexpr (SwapBytes) {
+        std::ranges::reverse(bits);
+    }
+    return std::bit_cast<T>(bits);
+}
+
+template <bool SwapBytes> auto readFloat(char const *data) -> float { return readRaw<float, SwapBytes>(data); }
+
+// Byte offsets of x, y, z, u and v within a vertex record, u and v only if the file has texture coordinates.
+struct FloatVertexLayout {
+    size_t record_size;
+    std::array<size_t, 5> offsets;
+    bool has_coords;
+};
+
+// Fast path for the common case where all the vertex properties we use are floats: they are decoded straight from
+// their offsets in each record, and whether to swap bytes is decided once for the whole element.
+template <bool SwapBytes>
+auto decodeFloatVertices(std::string_view records, size_t count, FloatVertexLayout const &layout,
+                         std::vector<Vec3> &positions, std::vector<Vec2> &texture_coords) -> void {
+    auto const &[x, y, z, u, v] = layout.offsets;
+    for (size_t i = 0; i < count; ++i) {
+        auto const *record = records.data() + i * layout.record_size;
+
+        // Flip X and Y axes to match what the rest of the engine expects.
+        positions.push_back(Vec3{-readFloat<SwapBytes>(record + x), -readFloat<SwapBytes>(record + y),
+                                 readFloat<SwapBytes>(record + z)});
+        if (layout.has_coords) {
+            texture_coords.push_back(Vec2{readFloat<SwapBytes>(record + u), readFloat<SwapBytes>(record + v)});
+        }
+    }
+}
+
+bool readVertices(PayloadReader &reader, Element const &element, std::vector<Vec3> &positions,
+                  std::vector<Vec2> &texture_coords) {
+    auto x = findProperty(element, {"x"});
+    auto y = findProperty(element, {"y"});
+    auto z = findProperty(element, {"z"});
+    if (x < 0 || y < 0 || z < 0 || !isFixedSize(element)) {
+        std::cerr << "PLY vertices need scalar x, y and z properties" << std::endl;
+        return false;
+    }
+
+    auto u = findProperty(element, {"u", "s", "texture_u", "texture_s"});
+    auto v = findProperty(element, {"v", "t", "texture_v", "texture_t"});
+    auto has_coords = u >= 0 && v >= 0;
+
+    auto record_size = size_t{0};
+    auto offsets = std::vector<size_t>{};
+    for (auto const &property : element.properties) {
+        offsets.push_back(record_size);
+        record_size += scalarSize(property.type);
+    }
+    if (!reader.canRead(element.count, record_size))
+        return false;
+
+    positions.reserve(element.count);
+    if (has_coords) {
+        texture_coords.reserve(element.count);
+    }
+
+    auto is_float = [&element](int property) { return element.properties[property].type == ScalarType::Float32; };
+    if (is_float(x) && is_float(y) && is_float(z) && (!has_coords || (is_float(u) && is_float(v)))) {
+        auto layout = FloatVertexLayout{
+            .record_size = record_size,
+            .offsets = {offsets[x], offsets[y], offsets[z], has_coords ? offsets[u] : 0, has_coords ? offsets[v] : 0},
+            .has_coords = has_coords};
+        auto records = reader.take(element.count * record_size);
+        if (reader.swapsBytes()) {
+            decodeFloatVertices<true>(records, element.count, layout, positions, texture_coords);
+        } else {
+            decodeFloatVertices<false>(records, element.count, layout, positions, texture_coords);
+        }
+        return true;
+    }
+
+    auto values = std::vector<double>(element.properties.size());
+    for (size_t i = 0; i < element.count; ++i) {
+        for (size_t p = 0; p < values.size(); ++p) {
+            values[p] = reader.readScalar(element.properties[p].type);
+        }
+
+        // Flip X and Y axes to match what the rest of the engine expects.
+        positions.push_back(
+            Vec3{-static_cast<float>(values[x]), -static_cast<float>(values[y]), static_cast<float>(values[z])});
+        if (has_coords) {
+            texture_coords.push_back(Vec2{static_cast<float>(values[u]), static_cast<float>(values[v])});
+        }
+    }
+
+    return true;
+}
+
+// Triangulates the polygon as a fan, PLY indices are 0-based.
+auto appendFan(std::vector<int> const &polygon, bool has_coords, std::vector<IndexedVertex> &indexed) -> void {
+    auto corner = [has_coords](int index) {
+        return IndexedVertex{.vertex_idx = index + 1,
+                             .coords_idx = has_coords ? std::optional<int>{index + 1} : std::nullopt};
+    };
+    for (int j = 2; j < std::ssize(polygon); ++j) {
+        indexed.push_back(corner(polygon[0]));
+        indexed.push_back(corner(polygon[j - 1]));
+        indexed.push_back(corner(polygon[j]));
+    }
+}
+
+// Fast path for faces that are nothing but a `list uchar int|uint vertex_indices`, the layout practically every
+// exporter writes. Whether to swap bytes is decided once for the whole element. Returns how many bytes of `payload` the
+// faces took up, or nothing if they don't fit or hold an invalid index.
+template <typename Index, bool SwapBytes>
+auto decodeFaceLists(std::string_view payload, size_t count, bool has_coords, std::vector<IndexedVertex> &indexed)
+    -> std::optional<size_t> {
+    auto polygon = std::vector<int>{};
+    auto offset = size_t{0};
+    for (size_t i = 0; i < count; ++i) {
+        if (offset >= payload.size())
+            return {};
+        auto corners = static_cast<uint8_t>(payload[offset]);
+        offset += 1;
+        if (corners > (payload.size() - offset) / sizeof(Index))
+            return {};
+
+        polygon.clear();
+        for (int j = 0; j < corners; ++j) {
+            auto index = toInt(readRaw<Index, SwapBytes>(payload.data() + offset));
+            if (!index)
+                return {};
+            polygon.push_back(*index);
+            offset += sizeof(Index);
+        }
+        appendFan(polygon, has_coords, indexed);
+    }
+    return offset;
+}
+
+template <typename Index>
+auto decodeFaceLists(PayloadReader &reader, size_t count, bool has_coords, std::vector<IndexedVertex> &indexed)
+    -> bool {
+    auto size = reader.swapsBytes() ? decodeFaceLists<Index, true>(reader.rest(), count, has_coords, indexed)
+                                    : decodeFaceLists<Index, false>(reader.rest(), count, has_coords, indexed);
+    if (!size)
+        return false;
+    reader.skip(*size);
+    return true;
+}
+
+bool readFaces(PayloadReader &reader, Element const &element, bool has_coords, std::vector<IndexedVertex> &indexed) {
+    auto indices_property = findProperty(element, {"vertex_indices", "vertex_index"});
+    if (indices_property < 0 || !element.properties[indices_property].count_type) {
+        std::cerr << "PLY faces need a vertex_indices list" << std::endl;
+        return false;
+    }
+
+    auto const &indices = element.properties[indices_property];
+    if (element.properties.size() == 1 && indices.count_type == ScalarType::Uint8) {
+        if (indices.type == ScalarType::Int32)
+            return decodeFaceLists<int32_t>(reader, element.count, has_coords, indexed);
+        if (indices.type == ScalarType::Uint32)
+            return decodeFaceLists<uint32_t>(reader, element.count, has_coords, indexed);
+    }
+
+    auto polygon = std::vector<int>{};
+    for (size_t i = 0; i < element.count; ++i) {
+        for (int p = 0; p < std::ssize(element.properties); ++p) {
+            auto const &property = element.properties[p];
+
+            if (!property.count_type) {
+                if (!reader.canRead(scalarSize(property.type)))
+                    return false;
+                reader.skip(scalarSize(property.type));
+                continue;
+            }
+
+            if (!reader.canRead(scalarSize(*property.count_type)))
+                return false;
+            auto count = toInt(reader.readScalar(*property.count_type));
+            if (!count || !reader.canRead(*count, scalarSize(property.type)))
+                return false;
+
+            if (p != indices_property) {
+                reader.skip(*count * scalarSize(property.type));
+                continue;
+            }
+
+            polygon.clear();
+            for (int j = 0; j < *count; ++j) {
+                auto index = toInt(reader.readScalar(property.type));
+                if (!index)
+                    return false;
+                polygon.push_back(*index);
+            }
+        }
+
+        appendFan(polygon, has_coords, indexed);
+    }
+
+    return true;
+}
+
+bool skipElement(PayloadReader &reader, Element const &element) {
+    for (size_t i = 0; i < element.count; ++i) {
+        for (auto const &property : element.properties) {
+            auto count = std::optional<int>{1};
+            if (property.count_type) {
+                if (!reader.canRead(scalarSize(*property.count_type)))
+                    return false;
+                count = toInt(reader.readScalar(*property.count_type));
+            }
+
+            if (!count || !reader.canRead(*count, scalarSize(property.type)))
+                return false;
+            reader.skip(*count * scalarSize(property.type));
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool hasPlyMagic(std::string_view contents) { return contents.starts_with("ply\n") || contents.starts_with("ply\r\n"); }
+
+std::optional<Mesh> parsePly(std::string_view contents) {
+    if (!hasPlyMagic(contents)) {
+        std::cerr << "Not a PLY file" << std::endl;
+        return {};
+    }
+
+    auto header = parseHeader(contents);
+    if (!header) {
+        std::cerr << "Invalid PLY header" << std::endl;
+        return {};
+    }
+
+    auto reader = PayloadReader(contents.substr(header->payload_offset), header->big_endian);
+
+    auto vertices = std::vector<Vec3>{};
+    auto texture_coords = std::vector<Vec2>{};
+    auto indexed = std::vector<IndexedVertex>{};
+
+    for (auto const &element : header->elements) {
+        auto ok = true;
+        if (element.name == "vertex") {
+            ok = readVertices(reader, element, vertices, texture_coords);
+        } else if (element.name == "face") {
+            ok = readFaces(reader, element, !texture_coords.empty(), indexed);
+        } else {
+            ok = skipElement(reader, element);
+        }
+
+        if (!ok) {
+            std::cerr << "Failed to read PLY element '" << element.name << "'" << std::endl;
+            return {};
+        }
+    }
+
+    Mesh mesh;
+    if (!meshFromIndexedData(vertices, texture_coords, indexed, mesh))
+        return {};
+
+    return mesh;
+}
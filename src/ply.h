@@ -0,0 +1,12 @@
+#pragma once
+
+#include <optional>
+#include <string_view>
+
+#include "mesh.h"
+
+// Binary PLY, either endianness. Reads x/y/z and, when present, u/v (or s/t) from the vertex element, and triangulates
+// the polygons of the face element.
+std::optional<Mesh> parsePly(std::string_view contents);
+
+bool hasPlyMagic(std::string_view contents);
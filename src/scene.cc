@@ -0,0 +1,166 @@
+#include "scene.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <span>
+
+#include "drawing.h"
+
+namespace {
+
+// Bounds of everything `transform` maps the box between `min` and `max` to on screen, in the same pixel grid
+// drawTriangle uses. Empty if it's all off screen.
+auto screenBounds(Vec3 const &min, Vec3 const &max, Mat4 const &transform, cv::Size screen) -> cv::Rect {
+    auto whole_screen = cv::Rect{0, 0, screen.width, screen.height};
+    if (min.x > max.x)
+        return {};
+
+    auto half = Vec2((screen.width - 1) / 2.f, (screen.height - 1) / 2.f);
+    auto x_min = std::numeric_limits<float>::max();
+    auto y_min = std::numeric_limits<float>::max();
+    auto x_max = std::numeric_limits<float>::lowest();
+    auto y_max = std::numeric_limits<float>::lowest();
+
+    for (int corner = 0; corner < 8; ++corner) {
+        auto x = (corner & 1) ? max.x : min.x;
+        auto y = (corner & 2) ? max.y : min.y;
+        auto z = (corner & 4) ? max.z : min.z;
+        auto p = Vec4{x, y, z, 1} * transform;
+
+        // The projection of a box that reaches behind the camera isn't bounded by its corners.
+        if (!(p[3] > 0))
+            return whole_screen;
+
+        auto screen_x = half.x * (p[0] / p[3]) + half.x;
+        auto screen_y = half.y * (p[1] / p[3]) + half.y;
+        x_min = std::min(x_min, screen_x);
+        x_max = std::max(x_max, screen_x);
+        y_min = std::min(y_min, screen_y);
+        y_max = std::max(y_max, screen_y);
+    }
+
+    // One pixel of margin covers both the rounding of vertex positions and the rounding errors in the corners.
+    auto to_pixel = [](float value, int size) { return static_cast<int>(std::clamp(value, -1.f, float(size))); };
+    auto x1 = to_pixel(std::floor(x_min) - 1, screen.width);
+    auto x2 = to_pixel(std::ceil(x_max) + 1, screen.width);
+    auto y1 = to_pixel(std::floor(y_min) - 1, screen.height);
+    auto y2 = to_pixel(std::ceil(y_max) + 1, screen.height);
+
+    return cv::Rect{x1, y1, x2 - x1 + 1, y2 - y1 + 1} & whole_screen;
+}
+
+// Merges overlapping rectangles in place until none of them overlap and returns the ones that are left.
+auto mergeOverlapping(std::span<cv::Rect> rects) -> std::span<cv::Rect> {
+    auto count = rects.size();
+    for (auto merged = true; merged;) {
+        merged = false;
+        for (size_t i = 0; i < count; ++i) {
+            for (auto j = i + 1; j < count;) {
+                if ((rects[i] & rects[j]).empty()) {
+                    ++j;
+                    continue;
+                }
+                rects[i] = rects[i] | rects[j];
+                rects[j] = rects[--count];
+                merged = true;
+            }
+        }
+    }
+    return rects.first(count);
+}
+
+} // namespace
+
+Scene::Scene(cv::Vec3b background) : background_(background) {}
+
+auto Scene::add(Mesh const &mesh, Mat4 const &transform) -> int {
+    auto bounds = Box{.min = Vec3{std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
+                                  std::numeric_limits<float>::max()},
+                      .max = Vec3{std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(),
+                                  std::numeric_limits<float>::lowest()}};
+    for (auto const &vertex : mesh.vertices) {
+        auto const &[x, y, z] = vertex.position;
+        bounds.min = Vec3{std::min(bounds.min.x, x), std::min(bounds.min.y, y), std::min(bounds.min.z, z)};
+        bounds.max = Vec3{std::max(bounds.max.x, x), std::max(bounds.max.y, y), std::max(bounds.max.z, z)};
+    }
+
+    objects_.push_back(Object{
+        .mesh = &mesh, .bounds = bounds, .transform = transform, .drawn_transform = std::nullopt, .drawn_rect = {}});
+    return static_cast<int>(objects_.size() - 1);
+}
+
+auto Scene::setTransform(int object, Mat4 const &transform) -> void {
+    assert(object >= 0 && object < std::ssize(objects_));
+    objects_[object].transform = transform;
+}
+
+auto Scene::setCamera(Mat4 const &view_projection) -> void {
+    // Moving the camera moves everything, there's nothing to gain from tracking regions.
+    if (view_projection != view_projection_) {
+        view_projection_ = view_projection;
+        needs_full_redraw_ = true;
+    }
+}
+
+auto Scene::render(FrameBuffer &fb, LinearArena &scratch) -> bool {
+    auto size = fb.render_target.size();
+    auto full_redraw = needs_full_redraw_ || size != drawn_size_;
+
+    // Every object that moved dirties both where it was and where it is now.
+    auto dirty = scratch.allocate<cv::Rect>(full_redraw ? 1 : 2 * objects_.size());
+    auto dirty_count = size_t{0};
+    auto mark_dirty = [&](cv::Rect const &rect) {
+        if (!rect.empty()) {
+            dirty[dirty_count++] = rect;
+        }
+    };
+
+    for (auto &object : objects_) {
+        if (!full_redraw && object.drawn_transform == object.transform)
+            continue;
+
+        auto rect = screenBounds(object.bounds.min, object.bounds.max, object.transform * view_projection_, size);
+        if (!full_redraw) {
+            mark_dirty(object.drawn_rect);
+            mark_dirty(rect);
+        }
+        object.drawn_transform = object.transform;
+        object.drawn_rect = rect;
+    }
+
+    if (full_redraw) {
+        mark_dirty(cv::Rect{0, 0, size.width, size.height});
+    }
+
+    needs_full_redraw_ = false;
+    drawn_size_ = size;
+
+    if (dirty_count == 0)
+        return false;
+
+    auto regions = mergeOverlapping(dirty.first(dirty_count));
+    for (auto const &region : regions) {
+        clear(fb, background_, region);
+    }
+
+    // Objects are drawn in the same order as in a full redraw, so depth ties resolve the same way and the regions end
+    // up exactly as if the whole frame had been redrawn.
+    auto clip_regions = scratch.allocate<cv::Rect>(regions.size());
+    for (auto const &object : objects_) {
+        auto clip_count = size_t{0};
+        for (auto const &region : regions) {
+            auto clip = object.drawn_rect & region;
+            if (!clip.empty()) {
+                clip_regions[clip_count++] = clip;
+            }
+        }
+
+        if (clip_count > 0) {
+            drawMesh(fb, *object.mesh, object.transform * view_projection_, scratch, clip_regions.first(clip_count));
+        }
+    }
+
+    return true;
+}
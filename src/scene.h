@@ -0,0 +1,53 @@
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "arena.h"
+#include "framebuffer.h"
+#include "math.h"
+#include "mesh.h"
+
+// A set of meshes that remembers what it last drew and where, so that a frame in which a few objects move only clears
+// and redraws the parts of the screen those objects covered before and after moving. Frames in which nothing changed
+// don't touch the framebuffer at all.
+//
+// The framebuffer has to keep what render() left in it between calls. Call invalidate() after drawing anything else
+// into it or when switching to a different framebuffer of the same size.
+class Scene {
+    struct Box {
+        Vec3 min;
+        Vec3 max;
+    };
+
+    struct Object {
+        Mesh const *mesh;
+        Box bounds;
+        Mat4 transform;
+        // What's currently in the framebuffer, unset until the object has been drawn once.
+        std::optional<Mat4> drawn_transform;
+        cv::Rect drawn_rect;
+    };
+
+    std::vector<Object> objects_;
+    Mat4 view_projection_{};
+    cv::Vec3b background_;
+    cv::Size drawn_size_{};
+    bool needs_full_redraw_ = true;
+
+  public:
+    explicit Scene(cv::Vec3b background);
+
+    // The mesh isn't copied and has to outlive the scene. Returns the id to use with setTransform().
+    auto add(Mesh const &mesh, Mat4 const &transform) -> int;
+    auto setTransform(int object, Mat4 const &transform) -> void;
+    auto setCamera(Mat4 const &view_projection) -> void;
+
+    auto invalidate() -> void { needs_full_redraw_ = true; }
+
+    // Brings the framebuffer up to date and returns false if nothing had to be drawn. Scratch memory comes from
+    // `scratch`, which can be reset right after the call.
+    auto render(FrameBuffer &fb, LinearArena &scratch) -> bool;
+};
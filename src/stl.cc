@@ -0,0 +1,82 @@
+#include "stl.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr size_t HEADER_SIZE = 80;
+constexpr size_t COUNT_SIZE = 4;
+constexpr size_t TRIANGLE_SIZE = 50;
+
+// Normal, three corners and the attribute byte count.
+constexpr size_t FIRST_CORNER_OFFSET = 12;
+constexpr size_t CORNER_SIZE = 12;
+
+template <typename T> auto readLittleEndian(char const *data) -> T {
+    auto bits = std::array<char, sizeof(T)>{};
+    std::memcpy(bits.data(), data, sizeof(T));
+    if constexpr (std::endian::native == std::endian::big) {
+        std::ranges::reverse(bits);
+    }
+    return std::bit_cast<T>(bits);
+}
+
+auto readTriangleCount(std::string_view contents) -> uint32_t {
+    return readLittleEndian<uint32_t>(contents.data() + HEADER_SIZE);
+}
+
+} // namespace
+
+bool looksLikeBinaryStl(std::string_view header, uintmax_t file_size) {
+    if (header.size() < HEADER_SIZE + COUNT_SIZE)
+        return false;
+
+    return file_size == HEADER_SIZE + COUNT_SIZE + uintmax_t{readTriangleCount(header)} * TRIANGLE_SIZE;
+}
+
+std::optional<Mesh> parseStl(std::string_view contents) {
+    if (!looksLikeBinaryStl(contents, contents.size())) {
+        std::cerr << "Not a binary STL file" << std::endl;
+        return {};
+    }
+
+    auto const num_corners = size_t{readTriangleCount(contents)} * 3;
+
+    // Positions are stored per corner, so merge them by sorting on their bit patterns.
+    using Key = std::array<uint32_t, 3>;
+    auto corners = std::vector<std::pair<Key, int>>{};
+    corners.reserve(num_corners);
+
+    auto const *payload = contents.data() + HEADER_SIZE + COUNT_SIZE;
+    for (size_t i = 0; i < num_corners; ++i) {
+        auto const *corner = payload + (i / 3) * TRIANGLE_SIZE + FIRST_CORNER_OFFSET + (i % 3) * CORNER_SIZE;
+        auto key = Key{readLittleEndian<uint32_t>(corner), readLittleEndian<uint32_t>(corner + 4),
+                       readLittleEndian<uint32_t>(corner + 8)};
+        corners.emplace_back(key, static_cast<int>(i));
+    }
+    std::ranges::sort(corners);
+
+    auto vertices = std::vector<Vec3>{};
+    auto indexed = std::vector<IndexedVertex>(num_corners);
+    for (size_t i = 0; i < corners.size(); ++i) {
+        auto const &[key, corner_idx] = corners[i];
+        if (i == 0 || key != corners[i - 1].first) {
+            auto const &[x, y, z] = key;
+            // Flip X and Y axes to match what the rest of the engine expects.
+            vertices.push_back(Vec3{-std::bit_cast<float>(x), -std::bit_cast<float>(y), std::bit_cast<float>(z)});
+        }
+        indexed[corner_idx] = IndexedVertex{.vertex_idx = static_cast<int>(std::ssize(vertices)), .coords_idx = {}};
+    }
+
+    Mesh mesh;
+    if (!meshFromIndexedData(vertices, {}, indexed, mesh))
+        return {};
+
+    return mesh;
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include "mesh.h"
+
+// Binary STL only. Corners with bit-identical positions are merged into one vertex.
+std::optional<Mesh> parseStl(std::string_view contents);
+
+// Binary STL has no magic number (its header may even start with "solid", like ASCII STL), but its size is fully
+// determined by the triangle count stored right after the header.
+bool looksLikeBinaryStl(std::string_view header, uintmax_t file_size);
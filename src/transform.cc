@@ -1,5 +1,6 @@
 #include "transform.h"
 
+#include <algorithm>
 #include <cmath>
 #include <numbers>
 
@@ -13,6 +14,16 @@ auto translationTransform(Vec3 const &translation) -> Mat4 {
     };
 }
 
+auto scaleTransform(Vec3 const &scale) -> Mat4 {
+    auto const &[sx, sy, sz] = scale;
+    return Mat4{
+        sx, 0,  0,  0, //
+        0,  sy, 0,  0, //
+        0,  0,  sz, 0, //
+        0,  0,  0,  1  //
+    };
+}
+
 auto lookAt(Vec3 const &eye, Vec3 const &at, Vec3 const &up) -> Mat4 {
     auto look_dir = normalize(at - eye);
     auto const &[x_d, y_d, z_d] = look_dir;
@@ -34,15 +45,24 @@ auto lookAt(Vec3 const &eye, Vec3 const &at, Vec3 const &up) -> Mat4 {
     return translation * rotation;
 }
 
-auto projectionTransform(float fov_y_degrees, float aspect_ratio_xy) -> Mat4 {
+auto projectionTransform(float fov_y_degrees, float aspect_ratio_xy, float near_plane) -> Mat4 {
     auto fov_rad = fov_y_degrees * std::numbers::pi / 180;
     float y = 1.0 / std::tan(fov_rad / 2.0);
     float x = y / aspect_ratio_xy;
 
     return Mat4{
-        x, 0, 0, 0, //
-        0, y, 0, 0, //
-        0, 0, 0, 1, //
-        0, 0, 1, 0  //
+        x, 0, 0,          0, //
+        0, y, 0,          0, //
+        0, 0, 0,          1, //
+        0, 0, near_plane, 0  //
     };
 }
+
+auto fitNearPlane(Mat4 const &view, Vec3 const &center, float radius) -> float {
+    constexpr float MIN_NEAR_PLANE_FRACTION = 1e-3f;
+
+    // lookAt puts the view direction in z, so this is the depth of the center.
+    auto const &[x, y, z] = center;
+    auto depth = (Vec4{x, y, z, 1} * view)[2];
+    return std::max(depth - radius, MIN_NEAR_PLANE_FRACTION * std::max(radius, 1.f));
+}
@@ -4,6 +4,15 @@
 
 auto translationTransform(Vec3 const &translation) -> Mat4;
 
+auto scaleTransform(Vec3 const &scale) -> Mat4;
+
 auto lookAt(Vec3 const &eye, Vec3 const &at, Vec3 const &up) -> Mat4;
 
-auto projectionTransform(float fov_y_degrees, float aspect_ratio_xy) -> Mat4;
+// Maps view-space depth to near_plane / depth, i.e. reversed-Z with an infinite far plane. Everything beyond the near
+// plane ends up in (0, 1], which is the range the unorm depth buffer formats can store.
+auto projectionTransform(float fov_y_degrees, float aspect_ratio_xy, float near_plane = 1) -> Mat4;
+
+// The near plane for projectionTransform that sits right in front of the sphere at `center` with `radius`, as seen
+// through `view`. That spreads the whole depth range over the sphere. Cameras close to or inside the sphere get a small
+// fraction of the radius instead.
+auto fitNearPlane(Mat4 const &view, Vec3 const &center, float radius) -> float;
@@ -103,29 +103,6 @@ bool tryParseNormal(std::string const &line) {
     return true;
 }
 
-struct IndexedVertex {
-    int vertex_idx;
-    std::optional<int> coords_idx;
-};
-
-auto operator<(IndexedVertex const &lhs, IndexedVertex const &rhs) -> bool {
-    if (lhs.vertex_idx != rhs.vertex_idx)
-        return lhs.vertex_idx < rhs.vertex_idx;
-
-    if (lhs.coords_idx.has_value() != rhs.coords_idx.has_value())
-        return !lhs.coords_idx.has_value();
-
-    if (lhs.coords_idx.has_value())
-        return lhs.coords_idx.value() < rhs.coords_idx.value();
-
-    return false;
-};
-
-auto operator==(IndexedVertex const &lhs, IndexedVertex const &rhs) -> bool {
-    return (lhs.vertex_idx == rhs.vertex_idx) && (lhs.coords_idx.has_value() == rhs.coords_idx.has_value()) &&
-           (lhs.coords_idx.has_value() ? (lhs.coords_idx.value() == rhs.coords_idx.value()) : true);
-};
-
 // Input must be trimmed
 bool tryParseVertexDescription(std::string description, std::vector<IndexedVertex> &indexed) {
     auto components = splitStr(description, '/', true);
@@ -190,78 +167,34 @@ auto tryParseLine(std::string const &line, std::vector<Vec3> &vertices, std::vec
         tryParseFace(line, indexed) || log_error(line);
 }
 
-auto deduplicateIndexedVertices(std::vector<IndexedVertex> const &indexed) {
-    auto indices_sorted = indexed;
-    std::ranges::sort(indices_sorted, std::less<IndexedVertex>{});
-
-    auto duplicates = std::ranges::unique(indices_sorted);
-    return std::vector<IndexedVertex>{indices_sorted.begin(), duplicates.begin()};
-}
-
-bool makeVertices(std::vector<IndexedVertex> const &indexed, std::vector<Vec3> const &positions,
-                  std::vector<Vec2> const &texture_coords, std::vector<Vertex> &vertices) {
-    vertices.clear();
-    vertices.reserve(indexed.size());
-
-    for (auto const &[pos_idx, coord_idx] : indexed) {
-        if (pos_idx < 1 || pos_idx > std::ssize(positions))
-            return false;
-
-        if (coord_idx.has_value() && (*coord_idx < 1 || *coord_idx > std::ssize(texture_coords)))
-            return false;
+} // namespace
 
-        vertices.push_back(Vertex{.position = positions[pos_idx - 1],
-                                  .texture_coords = coord_idx ? texture_coords[*coord_idx - 1] : Vec2{0.5, 0.5}});
-    }
+WavefrontData parseWavefront(std::istream &input) {
+    auto data = WavefrontData{};
 
-    return true;
-}
-
-bool meshFromIndexedData(std::vector<Vec3> const &vertices, std::vector<Vec2> const &texture_coords,
-                         std::vector<IndexedVertex> const &indexed, Mesh &mesh) {
-    auto deduplicated_indices = deduplicateIndexedVertices(indexed);
+    for (std::string line; std::getline(input, line);) {
+        auto trimmed = trimStr(line);
 
-    auto final_vertices = std::vector<Vertex>{};
-    if (!makeVertices(deduplicated_indices, vertices, texture_coords, final_vertices))
-        return false;
+        if (trimmed.empty())
+            continue;
 
-    auto final_indices = std::vector<int>{};
-    final_indices.reserve(indexed.size());
-    for (auto const &indexed_vertex : indexed) {
-        auto it = std::ranges::lower_bound(deduplicated_indices, indexed_vertex, std::less{});
-        assert(it != deduplicated_indices.end());
-        assert(*it == indexed_vertex);
-        final_indices.push_back(std::distance(deduplicated_indices.begin(), it));
+        tryParseLine(trimmed, data.vertices, data.texture_coords, data.indexed);
     }
 
-    mesh = Mesh{.vertices = std::move(final_vertices), .indices = std::move(final_indices)};
-    return true;
+    return data;
 }
 
-} // namespace
-
-std::optional<Mesh> readMeshFromFile(std::string const &path) {
+std::optional<Mesh> readWavefrontFile(std::string const &path) {
     auto input_file = std::ifstream(path);
     if (!input_file.good()) {
         std::cerr << "Failed to open file '" << trimStr(path) << "'" << std::endl;
         return {};
     }
 
-    auto vertices = std::vector<Vec3>{};
-    auto texture_coords = std::vector<Vec2>{};
-    auto indexed = std::vector<IndexedVertex>{};
-
-    for (std::string line; std::getline(input_file, line);) {
-        auto trimmed = trimStr(line);
-
-        if (trimmed.empty())
-            continue;
-
-        tryParseLine(trimmed, vertices, texture_coords, indexed);
-    }
+    auto data = parseWavefront(input_file);
 
     Mesh mesh;
-    if (!meshFromIndexedData(vertices, texture_coords, indexed, mesh))
+    if (!meshFromIndexedData(data.vertices, data.texture_coords, data.indexed, mesh))
         return {};
 
     return mesh;
@@ -1,8 +1,19 @@
 #pragma once
 
+#include <istream>
 #include <optional>
 #include <string>
+#include <vector>
 
 #include "mesh.h"
 
-std::optional<Mesh> readMeshFromFile(std::string const &path);
+// OBJ statements as they appear in the file, before they are turned into a Mesh.
+struct WavefrontData {
+    std::vector<Vec3> vertices;
+    std::vector<Vec2> texture_coords;
+    std::vector<IndexedVertex> indexed;
+};
+
+WavefrontData parseWavefront(std::istream &input);
+
+std::optional<Mesh> readWavefrontFile(std::string const &path);